@@ -0,0 +1,47 @@
+## texture atlas: packs data/images into atlas pages at build time ##
+## the game falls back to loading each image if no atlas is found   ##
+
+OPTION(ENABLE_ATLAS "Packs the game's images into texture atlases" ON)
+
+find_program(PYTHON_EXECUTABLE NAMES python3 python)
+
+if( ENABLE_ATLAS AND PYTHON_EXECUTABLE )
+
+    set(ATLAS_DIR "${CMAKE_BINARY_DIR}/build/${CLIENT}/bin/${GAMEDATA_FOLDER}/atlas")
+    set(ATLAS_PACKER "${CMAKE_SOURCE_DIR}/tools/pack_atlas.py")
+
+    ## drawn every frame, kept together on the first page
+    set(ATLAS_FIRST
+            "/data/images/defender.png"
+            "/data/images/green_alien.png"
+            "/data/images/SpaceShooterRedux/PNG/Lasers/laserRed01.png"
+            "/data/images/SpaceShooterRedux/PNG/Lasers/laserGreen01.png"
+            "/data/images/barrier.png"
+            "/data/images/destroyed_earth.png")
+
+    file(GLOB_RECURSE ATLAS_IMAGES
+            "${CMAKE_SOURCE_DIR}/${GAMEDATA_FOLDER}/images/*.png")
+
+    add_custom_command(
+            OUTPUT "${ATLAS_DIR}/atlas.json"
+            COMMAND ${PYTHON_EXECUTABLE} ${ATLAS_PACKER}
+                    "${CMAKE_SOURCE_DIR}/${GAMEDATA_FOLDER}/images"
+                    "/data/images"
+                    "${ATLAS_DIR}"
+                    ${ATLAS_FIRST}
+            DEPENDS ${ATLAS_PACKER} ${ATLAS_IMAGES}
+            COMMENT "Packing texture atlas"
+            VERBATIM)
+
+    add_custom_target(atlas ALL DEPENDS "${ATLAS_DIR}/atlas.json")
+    add_dependencies(${PROJECT_NAME} atlas)
+
+    foreach(TOOL_TARGET ${HEADLESS_TARGET} ${BENCHMARK_TARGET} ${STRESS_TARGET})
+        if(TARGET ${TOOL_TARGET})
+            add_dependencies(${TOOL_TARGET} atlas)
+        endif()
+    endforeach()
+
+elseif( ENABLE_ATLAS )
+    message("python not found, the texture atlas will not be packed")
+endif()
@@ -0,0 +1,117 @@
+## benchmark: replays recorded sessions through the headless game ##
+## and reports tick rate, update times and allocations per tick   ##
+
+OPTION(ENABLE_BENCHMARK "Adds the replay benchmark" ON)
+
+if( ENABLE_BENCHMARK AND ENABLE_HEADLESS )
+
+    set(BENCHMARK_TARGET ${PROJECT_NAME}Benchmark)
+
+    ## the benchmark has its own main, so the game's is left out
+    set(BENCHMARK_FILES
+            "game/game.cpp"
+            "game/Benchmark/main.cpp")
+
+    add_executable(
+            ${BENCHMARK_TARGET}
+            ${HEADER_FILES} ${HEADLESS_FILES} ${BENCHMARK_FILES})
+
+    set_target_properties(${BENCHMARK_TARGET}
+            PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/build/${CLIENT}/bin")
+
+    target_compile_definitions(${BENCHMARK_TARGET} PRIVATE HEADLESS)
+
+    target_include_directories(
+            ${BENCHMARK_TARGET} PRIVATE
+            "${CMAKE_CURRENT_SOURCE_DIR}/game")
+
+    target_include_directories(
+            ${BENCHMARK_TARGET} SYSTEM PRIVATE
+            "${CMAKE_SOURCE_DIR}/external/asge/include")
+
+    target_compile_options(
+            ${BENCHMARK_TARGET} PRIVATE
+            $<$<COMPILE_LANGUAGE:CXX>:${BUILD_FLAGS_FOR_CXX}>)
+
+    target_link_libraries(${BENCHMARK_TARGET} ASGE)
+
+    if(ENABLE_JSON)
+        target_link_libraries(${BENCHMARK_TARGET} jsonlib)
+    endif()
+
+    if(CMAKE_COMPILER_IS_GNUCC)
+        target_link_libraries(${BENCHMARK_TARGET} -no-pie pthread)
+    endif()
+
+endif()
+
+## stress benchmark: plays generated scenarios of any size in every ##
+## movement mode and reports the cost of each entity                ##
+
+if( ENABLE_BENCHMARK AND ENABLE_HEADLESS )
+
+    set(STRESS_TARGET ${PROJECT_NAME}Stress)
+
+    add_executable(
+            ${STRESS_TARGET}
+            ${HEADER_FILES} ${HEADLESS_FILES}
+            "game/game.cpp"
+            "game/Benchmark/stress.cpp")
+
+    set_target_properties(${STRESS_TARGET}
+            PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/build/${CLIENT}/bin")
+
+    target_compile_definitions(${STRESS_TARGET} PRIVATE HEADLESS)
+
+    target_include_directories(
+            ${STRESS_TARGET} PRIVATE
+            "${CMAKE_CURRENT_SOURCE_DIR}/game")
+
+    target_include_directories(
+            ${STRESS_TARGET} SYSTEM PRIVATE
+            "${CMAKE_SOURCE_DIR}/external/asge/include")
+
+    target_compile_options(
+            ${STRESS_TARGET} PRIVATE
+            $<$<COMPILE_LANGUAGE:CXX>:${BUILD_FLAGS_FOR_CXX}>)
+
+    target_link_libraries(${STRESS_TARGET} ASGE)
+
+    if(ENABLE_JSON)
+        target_link_libraries(${STRESS_TARGET} jsonlib)
+    endif()
+
+    if(CMAKE_COMPILER_IS_GNUCC)
+        target_link_libraries(${STRESS_TARGET} -no-pie pthread)
+    endif()
+
+endif()
+
+## trajectory benchmark: times the formation paths against the ##
+## per alien pow and sin they replaced                          ##
+
+if( ENABLE_BENCHMARK )
+
+    set(TRAJECTORY_BENCHMARK_TARGET ${PROJECT_NAME}TrajectoryBenchmark)
+
+    add_executable(
+            ${TRAJECTORY_BENCHMARK_TARGET}
+            "game/Movement/Trajectory.h"
+            "game/Movement/Trajectory.cpp"
+            "game/Benchmark/trajectory.cpp")
+
+    set_target_properties(${TRAJECTORY_BENCHMARK_TARGET}
+            PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/build/${CLIENT}/bin")
+
+    target_include_directories(
+            ${TRAJECTORY_BENCHMARK_TARGET} PRIVATE
+            "${CMAKE_CURRENT_SOURCE_DIR}/game")
+
+    target_compile_options(
+            ${TRAJECTORY_BENCHMARK_TARGET} PRIVATE
+            $<$<COMPILE_LANGUAGE:CXX>:${BUILD_FLAGS_FOR_CXX}>)
+
+endif()
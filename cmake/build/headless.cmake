@@ -0,0 +1,51 @@
+## headless build: the game compiled against a null renderer ##
+## runs without a window or GL context, uncapped by vsync     ##
+
+OPTION(ENABLE_HEADLESS "Adds a windowless build of the game" ON)
+
+if( ENABLE_HEADLESS )
+
+    set(HEADLESS_TARGET ${PROJECT_NAME}Headless)
+
+    set(HEADLESS_FILES
+            "game/Headless/HeadlessGame.h"
+            "game/Headless/HeadlessGame.cpp"
+            "game/Headless/NullRenderer.h"
+            "game/Headless/NullRenderer.cpp"
+            "game/Headless/NullSprite.h"
+            "game/Headless/NullSprite.cpp")
+
+    add_executable(
+            ${HEADLESS_TARGET}
+            ${HEADER_FILES} ${SOURCE_FILES} ${HEADLESS_FILES})
+
+    set_target_properties(${HEADLESS_TARGET}
+            PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/build/${CLIENT}/bin")
+
+    target_compile_definitions(${HEADLESS_TARGET} PRIVATE HEADLESS)
+
+    target_include_directories(
+            ${HEADLESS_TARGET} PRIVATE
+            "${CMAKE_CURRENT_SOURCE_DIR}/game")
+
+    target_include_directories(
+            ${HEADLESS_TARGET} SYSTEM PRIVATE
+            "${CMAKE_SOURCE_DIR}/external/asge/include")
+
+    target_compile_options(
+            ${HEADLESS_TARGET} PRIVATE
+            $<$<COMPILE_LANGUAGE:CXX>:${BUILD_FLAGS_FOR_CXX}>)
+
+    ## the null renderer still uses the engine's sprites and file system
+    target_link_libraries(${HEADLESS_TARGET} ASGE)
+
+    if(ENABLE_JSON)
+        target_link_libraries(${HEADLESS_TARGET} jsonlib)
+    endif()
+
+    if(CMAKE_COMPILER_IS_GNUCC)
+        target_link_libraries(${HEADLESS_TARGET} -no-pie pthread)
+    endif()
+
+endif()
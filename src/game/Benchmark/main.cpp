@@ -0,0 +1,411 @@
+#include "Headless/NullRenderer.h"
+#include "Rendering/FramePacket.h"
+#include "Rendering/FrameRenderer.h"
+#include "game.h"
+#include <Engine/FileIO.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+  std::atomic<unsigned long long> allocations{ 0 };
+
+  const unsigned int LEVEL_RESTARTS = 100;
+  const unsigned int RENDER_FRAMES = 1000;
+  const size_t RENDER_SPRITES = 600;
+  const size_t RENDER_TEXTS = 8;
+
+  struct SessionResult
+  {
+    unsigned long long ticks = 0;
+    double seconds = 0;
+    unsigned long long allocations = 0;
+    std::vector<double> frame_times;
+  };
+
+  struct SnapshotResult
+  {
+    size_t snapshots = 0;
+    size_t raw_bytes = 0;
+    size_t encoded_bytes = 0;
+    double encode_seconds = 0;
+    double decode_seconds = 0;
+  };
+
+  double percentile(std::vector<double> samples, double fraction)
+  {
+    if (samples.empty())
+    {
+      return 0;
+    }
+
+    auto rank = static_cast<size_t>(fraction *
+                                    static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+  }
+
+  void report(const std::string& name, const SessionResult& result)
+  {
+    const auto ticks = static_cast<double>(std::max(result.ticks, 1ULL));
+
+    std::cout << std::left << std::setw(40) << name << std::right
+              << std::setw(8) << result.ticks << " ticks" << std::setw(12)
+              << std::fixed << std::setprecision(0)
+              << static_cast<double>(result.ticks) / result.seconds
+              << " ticks/s" << std::setprecision(2) << std::setw(10)
+              << percentile(result.frame_times, 0.5) * 1e6 << "us p50"
+              << std::setw(10) << percentile(result.frame_times, 0.99) * 1e6
+              << "us p99" << std::setw(10)
+              << static_cast<double>(result.allocations) / ticks
+              << " allocs/tick" << std::endl;
+  }
+
+  void report(const std::string& name, const SnapshotResult& result)
+  {
+    const auto snapshots =
+      static_cast<double>(std::max<size_t>(result.snapshots, 1));
+    const auto raw_megabytes = static_cast<double>(result.raw_bytes) / 1e6;
+
+    std::cout << std::left << std::setw(40) << name << std::right
+              << std::setw(8) << result.snapshots << " snaps" << std::setw(10)
+              << std::fixed << std::setprecision(0)
+              << static_cast<double>(result.raw_bytes) / snapshots
+              << " B raw" << std::setw(10) << std::setprecision(1)
+              << static_cast<double>(result.encoded_bytes) / snapshots
+              << " B delta" << std::setw(10) << std::setprecision(0)
+              << raw_megabytes / std::max(result.encode_seconds, 1e-9)
+              << " MB/s enc" << std::setw(10)
+              << raw_megabytes / std::max(result.decode_seconds, 1e-9)
+              << " MB/s dec" << std::endl;
+  }
+
+  /**
+   *  The recordings shipped in the game's data folder, found through a
+   *  throwaway game as the data folder is only mounted by init.
+   */
+  std::vector<std::string> defaultCorpus()
+  {
+    std::vector<std::string> corpus;
+
+    SpaceInvaders game;
+    if (game.init())
+    {
+      for (const auto& file : ASGE::FILEIO::enumerateFiles("/data/replays"))
+      {
+        corpus.push_back("/data/replays/" + file);
+      }
+    }
+
+    std::sort(corpus.begin(), corpus.end());
+    return corpus;
+  }
+
+  bool replay(const std::string& session, SessionResult& result)
+  {
+    SpaceInvaders game;
+    if (!game.init() || !game.replayInputs(session))
+    {
+      return false;
+    }
+
+    game.recordFrameTimes(static_cast<size_t>(game.replayLength()) + 1);
+
+    const auto allocated_before = allocations.load();
+    game.run();
+    result.allocations = allocations.load() - allocated_before;
+
+    result.ticks = game.ticksRun();
+    result.seconds = game.secondsRun();
+    result.frame_times = game.frameTimes();
+    return true;
+  }
+
+  /**
+   *  Replays a session keeping a snapshot of every tick, then decodes
+   *  the last snapshot back out of the history. The decoded snapshot is
+   *  restored into the game and saved again, and must come back byte for
+   *  byte, which checks the delta encoding and the restore together.
+   *  @return false if the session could not be replayed or round tripped
+   */
+  bool snapshot(const std::string& session, SnapshotResult& result)
+  {
+    SpaceInvaders game;
+    if (!game.init() || !game.replayInputs(session))
+    {
+      return false;
+    }
+
+    game.keepHistory(static_cast<size_t>(game.replayLength()) + 1);
+    game.run();
+
+    const StateHistory& history = game.history();
+    result.snapshots = history.size();
+    result.raw_bytes = history.rawBytes();
+    result.encoded_bytes = history.encodedBytes();
+    result.encode_seconds = history.encodeSeconds();
+    if (history.size() == 0)
+    {
+      return true;
+    }
+
+    std::vector<std::uint8_t> last;
+    const auto start = std::chrono::steady_clock::now();
+    const bool decoded = history.restore(history.size() - 1, last);
+    result.decode_seconds = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+
+    std::vector<std::uint8_t> saved;
+    if (!decoded || !game.restoreState(last))
+    {
+      return false;
+    }
+    game.saveState(saved);
+    return saved == last;
+  }
+
+  struct ArenaResult
+  {
+    size_t heap_allocations = 0; /**< Blocks taken by the first build. */
+    size_t bytes_used = 0;       /**< Bytes used by the first build. */
+    bool stable = true;
+  };
+
+  /**
+   *  Builds a level, then rebuilds it as a restart does, checking after
+   *  every rebuild that the level arena took no more blocks from the
+   *  heap and handed out exactly the bytes the first build did.
+   *  @return false if a level could not be built
+   */
+  bool levelRestarts(unsigned int restarts, ArenaResult& result)
+  {
+    SpaceInvaders game;
+    if (!game.init() || !game.rebuildLevel())
+    {
+      return false;
+    }
+
+    const Arena& arena = game.levelArena();
+    result.heap_allocations = arena.heapAllocations();
+    result.bytes_used = arena.bytesUsed();
+    for (unsigned int restart = 0; restart < restarts; ++restart)
+    {
+      if (!game.rebuildLevel())
+      {
+        return false;
+      }
+
+      result.stable = result.stable &&
+                      arena.heapAllocations() == result.heap_allocations &&
+                      arena.bytesUsed() == result.bytes_used;
+    }
+    return result.bytes_used > 0;
+  }
+
+  /**
+   *  Draws the same frame repeatedly, once it has been drawn to warm the
+   *  renderer's buffers, drawing every image in the data folder and the
+   *  longest lines of text a packet can hold.
+   *  @param [in] frames The number of frames to draw
+   *  @param [out] allocated The allocations made by the repeated frames
+   *  @return false if the data folder or its images could not be loaded
+   */
+  bool renderAllocations(unsigned int frames, unsigned long long& allocated)
+  {
+    // only used to mount the data folder
+    SpaceInvaders game;
+    if (!game.init())
+    {
+      return false;
+    }
+
+    NullRenderer renderer;
+    FrameRenderer frame_renderer;
+    for (const auto& file : ASGE::FILEIO::enumerateFiles("/data/images"))
+    {
+      frame_renderer.addSprite(&renderer, "/data/images/" + file);
+    }
+
+    if (frame_renderer.size() == 0)
+    {
+      return false;
+    }
+
+    FramePacket packet;
+    packet.reserve(RENDER_SPRITES, RENDER_TEXTS);
+    packet.clearStatic(1);
+    for (size_t i = 0; i < RENDER_SPRITES; ++i)
+    {
+      const auto sprite = static_cast<std::uint16_t>(i % frame_renderer.size());
+      const auto z = static_cast<std::int16_t>(i % 3);
+      if (i % 4 == 0)
+      {
+        packet.addStaticSprite(sprite, static_cast<float>(i), 0, z);
+      }
+      else
+      {
+        packet.addSprite(sprite, static_cast<float>(i), 0, z);
+      }
+    }
+
+    const std::string longest(TextDraw::LENGTH - 1, 'W');
+    for (size_t line = 0; line < RENDER_TEXTS; ++line)
+    {
+      packet.addText(longest.c_str(), 0, static_cast<float>(line));
+    }
+
+    frame_renderer.reserve(RENDER_SPRITES, RENDER_TEXTS);
+    frame_renderer.render(&renderer, packet);
+
+    const auto allocated_before = allocations.load();
+    for (unsigned int frame = 0; frame < frames; ++frame)
+    {
+      frame_renderer.render(&renderer, packet);
+    }
+    allocated = allocations.load() - allocated_before;
+    return true;
+  }
+}
+
+/**
+ *  Counts every allocation made by the process, the benchmark reports
+ *  the number made while a session is being replayed.
+ */
+void* operator new(std::size_t size)
+{
+  ++allocations;
+  if (void* memory = std::malloc(size == 0 ? 1 : size))
+  {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+/**
+ *  Usage: SpaceInvadersBenchmark [recording...]
+ *  Replays each recorded session headlessly, as fast as possible, and
+ *  reports the simulation rate, the median and 99th percentile frame
+ *  time and the heap allocations made per tick. With no recordings
+ *  given, the sessions in data/replays are used. Each session is then
+ *  replayed again snapshotting every tick, reporting the bytes per
+ *  snapshot, raw and delta encoded, and the encode and decode rates,
+ *  and fails if the last snapshot does not round trip. Then restarts a
+ *  level repeatedly and fails if the level arena goes back to the heap
+ *  or uses a different number of bytes than the first build. Finally
+ *  checks that drawing a frame allocates nothing once the renderer is
+ *  warm, and fails if it does.
+ */
+int main(int argc, char* argv[])
+{
+  std::vector<std::string> corpus(argv + 1, argv + argc);
+  if (corpus.empty())
+  {
+    corpus = defaultCorpus();
+  }
+
+  if (corpus.empty())
+  {
+    std::cerr << "no recordings to replay" << std::endl;
+    return 1;
+  }
+
+  SessionResult total;
+  for (const auto& session : corpus)
+  {
+    SessionResult result;
+    if (!replay(session, result))
+    {
+      std::cerr << "could not replay " << session << std::endl;
+      return 1;
+    }
+
+    report(session, result);
+
+    total.ticks += result.ticks;
+    total.seconds += result.seconds;
+    total.allocations += result.allocations;
+    total.frame_times.insert(total.frame_times.end(),
+                              result.frame_times.begin(),
+                              result.frame_times.end());
+  }
+
+  report("total", total);
+
+  SnapshotResult snapshot_total;
+  for (const auto& session : corpus)
+  {
+    SnapshotResult result;
+    if (!snapshot(session, result))
+    {
+      std::cerr << "snapshots of " << session << " did not round trip"
+                << std::endl;
+      return 1;
+    }
+
+    report(session, result);
+
+    snapshot_total.snapshots += result.snapshots;
+    snapshot_total.raw_bytes += result.raw_bytes;
+    snapshot_total.encoded_bytes += result.encoded_bytes;
+    snapshot_total.encode_seconds += result.encode_seconds;
+    snapshot_total.decode_seconds += result.decode_seconds;
+  }
+
+  report("snapshot total", snapshot_total);
+
+  ArenaResult arena;
+  if (!levelRestarts(LEVEL_RESTARTS, arena))
+  {
+    std::cerr << "could not build a level" << std::endl;
+    return 1;
+  }
+
+  std::cout << std::left << std::setw(40) << "level arena" << std::right
+            << std::setw(8) << LEVEL_RESTARTS << " restarts" << std::setw(8)
+            << arena.heap_allocations << " blocks" << std::setw(10)
+            << arena.bytes_used << " bytes" << std::endl;
+
+  if (!arena.stable)
+  {
+    std::cerr << "restarting a level went back to the heap" << std::endl;
+    return 1;
+  }
+
+  unsigned long long render_allocations = 0;
+  if (!renderAllocations(RENDER_FRAMES, render_allocations))
+  {
+    std::cerr << "could not load the images to draw" << std::endl;
+    return 1;
+  }
+
+  std::cout << std::left << std::setw(40) << "render" << std::right
+            << std::setw(8) << RENDER_FRAMES << " frames" << std::setw(10)
+            << std::setprecision(2)
+            << static_cast<double>(render_allocations) / RENDER_FRAMES
+            << " allocs/frame" << std::endl;
+
+  if (render_allocations != 0)
+  {
+    std::cerr << "drawing a frame allocated in the steady state" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,150 @@
+#include "Levels/Scenario.h"
+#include "Profiler/Profiler.h"
+#include "game.h"
+#include <Engine/Keys.h>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const char* const MODE_NAMES[] = { "linear", "gravity", "quadratic", "sine" };
+
+  // the area the formation is packed into, below the top of the screen
+  const float FORMATION_WIDTH = 1080.0F;
+  const float FORMATION_HEIGHT = 160.0F;
+
+  /**
+   *  The mean time of a zone over the run, summed over its calls and
+   *  spread over a number of steps.
+   *  @return the time per step, in microseconds
+   */
+  double zoneMicroseconds(const std::vector<ZoneStats>& zones,
+                          const char* name,
+                          unsigned long long steps)
+  {
+    for (const auto& zone : zones)
+    {
+      if (std::strcmp(zone.name, name) == 0 && steps > 0)
+      {
+        return zone.total_ms * 1e3 / static_cast<double>(steps);
+      }
+    }
+    return 0;
+  }
+
+  void reportCost(double microseconds, size_t entities)
+  {
+    std::cout << std::setw(10) << microseconds << "us" << std::setw(9)
+              << microseconds * 1e3 / static_cast<double>(entities) << "ns";
+  }
+
+  /**
+   *  Plays a stress scenario in one movement mode, reporting the cost of
+   *  a tick's update and collisions and of a frame's render submission,
+   *  in total and per entity.
+   *  @return false if the game could not start
+   */
+  bool stress(int mode,
+              size_t aliens,
+              size_t shots,
+              unsigned long long frames)
+  {
+    SpaceInvaders game;
+    game.setScenario(
+      stressScenario(aliens, shots, FORMATION_WIDTH, FORMATION_HEIGHT));
+    if (!game.init())
+    {
+      return false;
+    }
+
+    for (int i = 0; i < mode; ++i)
+    {
+      game.sendKey(ASGE::KEYS::KEY_DOWN, ASGE::KEYS::KEY_RELEASED);
+    }
+    game.sendKey(ASGE::KEYS::KEY_ENTER, ASGE::KEYS::KEY_PRESSED);
+
+    game.frameLimit(frames);
+    const std::int64_t since = Profiler::now();
+    game.run();
+
+    std::vector<ZoneStats> zones;
+    Profiler::getInstance().summarise(since, zones);
+
+    const unsigned long long ticks = game.ticksRun();
+    const size_t entities = aliens + 2 * shots;
+    std::cout << std::left << std::setw(10) << MODE_NAMES[mode] << std::right
+              << std::setw(8) << aliens << std::setw(6) << shots
+              << std::setw(6) << ticks << std::fixed << std::setprecision(1);
+    reportCost(zoneMicroseconds(zones, "simulate", ticks), entities);
+    reportCost(zoneMicroseconds(zones, "collision", ticks), entities);
+    reportCost(zoneMicroseconds(zones, "renderSprite frame", game.framesRun()),
+               entities);
+    std::cout << std::endl;
+    return true;
+  }
+}
+
+/**
+ *  Usage: SpaceInvadersStress [--frames n] [--shots n] [aliens...]
+ *  Plays generated stress scenarios headlessly in every movement mode,
+ *  one per formation size, each with the given number of shots allowed
+ *  in flight on both sides. Reports the time taken by a tick's update
+ *  and its collisions and by a frame's render submission, in total and
+ *  per entity, where the entities are the aliens and every shot slot.
+ *  Defaults to 120 frames of formations of 1000, 10000 and 100000
+ *  aliens with 256 shots.
+ */
+int main(int argc, char* argv[])
+{
+  unsigned long long frames = 120;
+  size_t shots = 256;
+  std::vector<size_t> counts;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+    {
+      frames = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--shots") == 0 && i + 1 < argc)
+    {
+      shots = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else
+    {
+      counts.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+  }
+
+  if (counts.empty())
+  {
+    counts = { 1000, 10000, 100000 };
+  }
+
+  std::cout << std::left << std::setw(10) << "mode" << std::right
+            << std::setw(8) << "aliens" << std::setw(6) << "shots"
+            << std::setw(6) << "ticks" << std::setw(23) << "update/tick"
+            << std::setw(23) << "collision/tick" << std::setw(23)
+            << "render/frame" << std::endl;
+
+  for (int mode = 0; mode < 4; ++mode)
+  {
+    for (const size_t aliens : counts)
+    {
+      if (aliens == 0)
+      {
+        continue;
+      }
+
+      if (!stress(mode, aliens, shots, frames))
+      {
+        std::cerr << "could not start the game" << std::endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,204 @@
+#include "Movement/Trajectory.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const float ROW_SPACING = 20.0F;
+  const size_t ALIENS_PER_ROW = 10;
+
+  volatile float sink = 0;
+
+  /**
+   *  The quadratic movement the trajectory engine replaced: pow in
+   *  double for every alien, with the row picked by a branch ladder.
+   */
+  void referenceQuadratic(const std::vector<float>& x, std::vector<float>& y)
+  {
+    for (size_t i = 0; i < x.size(); i++)
+    {
+      const size_t row = i / ALIENS_PER_ROW;
+      double base = 0;
+      if (row == 0)
+      {
+        base = 200;
+      }
+      else if (row == 1)
+      {
+        base = 220;
+      }
+      else if (row == 2)
+      {
+        base = 240;
+      }
+      else if (row == 3)
+      {
+        base = 260;
+      }
+      else
+      {
+        base = 280;
+      }
+
+      y[i] = static_cast<float>(
+        (-0.0002 * std::pow(static_cast<double>(x[i]) - 640.0, 2.0)) + base);
+    }
+  }
+
+  /**
+   *  The sine movement the trajectory engine replaced: sin in double
+   *  for every alien.
+   */
+  void referenceSine(const std::vector<float>& x, std::vector<float>& y)
+  {
+    for (size_t i = 0; i < x.size(); i++)
+    {
+      y[i] = static_cast<float>(50 * std::sin(0.01 * x[i]));
+    }
+  }
+
+  void engineQuadratic(const Trajectory& path,
+                       const std::vector<float>& x,
+                       std::vector<float>& y)
+  {
+    path.evaluate(x.data(), y.data(), x.size());
+    for (size_t i = 0; i < y.size(); i++)
+    {
+      const auto row = std::min<size_t>(i / ALIENS_PER_ROW, 4);
+      y[i] += ROW_SPACING * static_cast<float>(row);
+    }
+  }
+
+  void engineSine(const Trajectory& path,
+                  const std::vector<float>& x,
+                  std::vector<float>& y)
+  {
+    path.evaluate(x.data(), y.data(), x.size());
+  }
+
+  /**
+   *  Runs a function over the positions until enough time has passed
+   *  to measure it.
+   *  @return the mean time per alien, in nanoseconds
+   */
+  template <typename Function>
+  double time(Function function,
+              const std::vector<float>& x,
+              std::vector<float>& y)
+  {
+    const double min_seconds = 0.2;
+    unsigned long long runs = 0;
+    double seconds = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    while (seconds < min_seconds)
+    {
+      function(x, y);
+      sink = sink + y[runs % y.size()];
+      ++runs;
+      seconds = std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    }
+
+    return seconds * 1e9 / static_cast<double>(runs * x.size());
+  }
+
+  double maxError(const std::vector<float>& a, const std::vector<float>& b)
+  {
+    double error = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+      error = std::max(error, std::fabs(static_cast<double>(a[i] - b[i])));
+    }
+    return error;
+  }
+
+  void report(const std::string& name,
+              size_t count,
+              double reference_ns,
+              double engine_ns,
+              double error)
+  {
+    std::cout << std::left << std::setw(12) << name << std::right
+              << std::setw(8) << count << " aliens" << std::fixed
+              << std::setprecision(2) << std::setw(10) << reference_ns
+              << "ns ref" << std::setw(10) << engine_ns << "ns path"
+              << std::setw(8) << reference_ns / engine_ns << "x"
+              << std::setprecision(5) << std::setw(12) << error
+              << " max error" << std::endl;
+  }
+}
+
+/**
+ *  Usage: SpaceInvadersTrajectoryBenchmark [aliens...]
+ *  Times the quadratic and sine formation paths from the trajectory
+ *  engine against the per alien pow and sin they replaced, over packed
+ *  positions spread across the screen, and reports the time per alien
+ *  and the largest difference between the two. Defaults to a wave of
+ *  50 aliens and a swarm of 100000.
+ */
+int main(int argc, char* argv[])
+{
+  std::vector<size_t> counts;
+  for (int i = 1; i < argc; ++i)
+  {
+    counts.push_back(std::strtoull(argv[i], nullptr, 10));
+  }
+
+  if (counts.empty())
+  {
+    counts = { 50, 100000 };
+  }
+
+  const PolynomialTrajectory quadratic(
+    { QUADRATIC_HEIGHT, 0, QUADRATIC_CURVE }, QUADRATIC_ORIGIN);
+  const TableTrajectory sine(sineRise, SINE_PERIOD, SINE_SAMPLES);
+
+  std::minstd_rand rng(1);
+  std::uniform_real_distribution<float> screen(0.0F, 1280.0F);
+
+  for (const size_t count : counts)
+  {
+    if (count == 0)
+    {
+      continue;
+    }
+
+    std::vector<float> x(count);
+    std::generate(x.begin(), x.end(), [&]() { return screen(rng); });
+    std::vector<float> expected(count);
+    std::vector<float> actual(count);
+
+    const double quadratic_ref = time(referenceQuadratic, x, expected);
+    const double quadratic_ns = time(
+      [&quadratic](const std::vector<float>& in, std::vector<float>& out) {
+        engineQuadratic(quadratic, in, out);
+      },
+      x,
+      actual);
+    report("quadratic",
+           count,
+           quadratic_ref,
+           quadratic_ns,
+           maxError(expected, actual));
+
+    const double sine_ref = time(referenceSine, x, expected);
+    const double sine_ns = time(
+      [&sine](const std::vector<float>& in, std::vector<float>& out) {
+        engineSine(sine, in, out);
+      },
+      x,
+      actual);
+    report("sine", count, sine_ref, sine_ns, maxError(expected, actual));
+  }
+
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include "SpriteComponent.h"
+#include "Resources/TextureCache.h"
 #include <Engine/Renderer.h>
 
 SpriteComponent::~SpriteComponent()
@@ -7,11 +8,19 @@ SpriteComponent::~SpriteComponent()
 }
 
 bool SpriteComponent::loadSprite(ASGE::Renderer* renderer,
-                                 const std::string& texture_file_name)
+                                 const std::string& texture_file_name,
+                                 bool shared)
 {
   free();
-  sprite = renderer->createRawSprite();
-  if (sprite->loadTexture(texture_file_name))
+
+  if (shared)
+  {
+    sprite = TextureCache::getInstance().load(renderer, texture_file_name);
+    return sprite != nullptr;
+  }
+
+  sprite.reset(renderer->createRawSprite());
+  if (TextureCache::getInstance().loadTexture(*sprite, texture_file_name))
   {
     return true;
   }
@@ -22,14 +31,10 @@ bool SpriteComponent::loadSprite(ASGE::Renderer* renderer,
 
 void SpriteComponent::free()
 {
-  if (sprite)
-  {
-    delete sprite;
-    sprite = nullptr;
-  }
+  sprite.reset();
 }
 
 ASGE::Sprite* SpriteComponent::getSprite()
 {
-  return sprite;
+  return sprite.get();
 }
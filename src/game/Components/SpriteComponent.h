@@ -1,5 +1,7 @@
 #pragma once
 #include <Engine/Sprite.h>
+#include <memory>
+#include <string>
 /**
  *  Sprite Components are used by GameObjects
  *  A component based approach allows GameObjects to decide
@@ -25,13 +27,18 @@ class SpriteComponent
    *  Allocates and loads the sprite.
    *  Part of this process will attempt to load a texture file.
    *  If this fails this function will return false and the memory
-   *  allocated, freed.
+   *  allocated, freed. Shared sprites come from the TextureCache and
+   *  are used by every component sharing the texture, so they must be
+   *  positioned right before they are rendered.
    *  @param [in] renderer The renderer used to perform the allocations
    *  @param [in] texture_file_name The file path to the the texture to load
+   *  @param [in] shared Share the sprite with others using the texture
    *  @return true if the sprite was successfully loaded
+   *  @see TextureCache
    */
-  bool
-  loadSprite(ASGE::Renderer* renderer, const std::string& texture_file_name);
+  bool loadSprite(ASGE::Renderer* renderer,
+                  const std::string& texture_file_name,
+                  bool shared = false);
 
   /**
    *  Returns a pointer to the sprite residing in this component.
@@ -43,5 +50,5 @@ class SpriteComponent
 
  private:
   void free();
-  ASGE::Sprite* sprite = nullptr;
+  std::shared_ptr<ASGE::Sprite> sprite = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+#include "Entity.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ *  Sparse set of one type of component.
+ *  The components are packed densely, in no particular order, next to
+ *  the entities that own them, so a system walks a contiguous array
+ *  rather than visiting every entity to see whether it has one. The
+ *  sparse array maps an entity to where its component sits, making
+ *  add, remove and lookup O(1). Removing swaps the last component into
+ *  the hole, so pointers and indices into the pool do not survive it.
+ */
+template <typename T> class ComponentPool
+{
+ public:
+  /**
+   *  Gives an entity the component, replacing any it already had.
+   *  @param [in] entity The owner
+   *  @param [in] component The initial value
+   *  @return the stored component
+   */
+  T& add(Entity entity, const T& component)
+  {
+    if (entity >= sparse.size())
+    {
+      sparse.resize(entity + size_t{ 1 }, ABSENT);
+    }
+
+    if (sparse[entity] != ABSENT)
+    {
+      return components[sparse[entity]] = component;
+    }
+
+    sparse[entity] = static_cast<std::uint32_t>(dense.size());
+    dense.push_back(entity);
+    components.push_back(component);
+    return components.back();
+  }
+
+  /**
+   *  Takes the component away from an entity, if it has one.
+   *  @param [in] entity The owner
+   */
+  void remove(Entity entity) noexcept
+  {
+    if (!contains(entity))
+    {
+      return;
+    }
+
+    const std::uint32_t hole = sparse[entity];
+    const Entity last = dense.back();
+
+    dense[hole] = last;
+    components[hole] = components.back();
+    sparse[last] = hole;
+    sparse[entity] = ABSENT;
+
+    dense.pop_back();
+    components.pop_back();
+  }
+
+  bool contains(Entity entity) const noexcept
+  {
+    return entity < sparse.size() && sparse[entity] != ABSENT;
+  }
+
+  /**
+   *  The entity's component. The entity must have one.
+   *  @param [in] entity The owner
+   *  @return the component
+   */
+  T& get(Entity entity) noexcept { return components[sparse[entity]]; }
+  const T& get(Entity entity) const noexcept
+  {
+    return components[sparse[entity]];
+  }
+
+  /**
+   *  The entity's component, if it has one.
+   *  @param [in] entity The owner
+   *  @return the component, or nullptr
+   */
+  T* find(Entity entity) noexcept
+  {
+    return contains(entity) ? &components[sparse[entity]] : nullptr;
+  }
+  const T* find(Entity entity) const noexcept
+  {
+    return contains(entity) ? &components[sparse[entity]] : nullptr;
+  }
+
+  /**
+   *  The owners of the packed components, in the same order.
+   *  @return the entity that owns each component
+   */
+  const std::vector<Entity>& entities() const noexcept { return dense; }
+
+  T* data() noexcept { return components.data(); }
+  const T* data() const noexcept { return components.data(); }
+  size_t size() const noexcept { return dense.size(); }
+
+  /**
+   *  Reserves memory up front.
+   *  @param [in] count The number of components expected
+   */
+  void reserve(size_t count)
+  {
+    sparse.reserve(count);
+    dense.reserve(count);
+    components.reserve(count);
+  }
+
+  /**
+   *  Removes every component, keeping the memory for reuse.
+   */
+  void clear() noexcept
+  {
+    for (const Entity entity : dense)
+    {
+      sparse[entity] = ABSENT;
+    }
+    dense.clear();
+    components.clear();
+  }
+
+ private:
+  static constexpr std::uint32_t ABSENT = 0xFFFFFFFFU;
+
+  std::vector<std::uint32_t> sparse;
+  std::vector<Entity> dense;
+  std::vector<T> components;
+};
+
+template <typename T> constexpr std::uint32_t ComponentPool<T>::ABSENT;
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+
+/**
+ *  Where an entity is, this tick and last. Render interpolates between
+ *  the two.
+ */
+struct Transform
+{
+  float x = 0;
+  float y = 0;
+  float prev_x = 0;
+  float prev_y = 0;
+};
+
+/**
+ *  How far an entity moves per second. Integrated into its transform
+ *  once per tick.
+ */
+struct Velocity
+{
+  float x = 0;
+  float y = 0;
+};
+
+/**
+ *  The extent of an entity from its transform, and the collision layer
+ *  it is tested on.
+ */
+struct Collider
+{
+  float width = 0;
+  float height = 0;
+  std::uint32_t layer = 0;
+};
+
+/**
+ *  Hits an entity can take. It is destroyed once they run out.
+ */
+struct Health
+{
+  int hit_points = 1;
+};
+
+/**
+ *  An alien's place in the invading formation.
+ */
+struct FormationSlot
+{
+  std::uint32_t column = 0;
+  std::uint32_t row = 0;
+};
+
+/**
+ *  How an entity is drawn: the id of its sprite in the FrameRenderer,
+ *  its depth, and whether it belongs to the static layer because it
+ *  never moves.
+ */
+struct Drawable
+{
+  std::uint16_t sprite = 0;
+  std::int16_t z = 0;
+  bool fixed = false;
+};
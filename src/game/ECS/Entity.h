@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+/**
+ *  An entity is nothing more than an id. Everything about it is held
+ *  in the registry's component pools, indexed by that id.
+ *  @see Registry
+ */
+using Entity = std::uint32_t;
+
+/**
+ *  Returned in place of an entity that could not be created.
+ */
+constexpr Entity NULL_ENTITY = 0xFFFFFFFFU;
@@ -0,0 +1,119 @@
+#include "Registry.h"
+
+Registry::Registry(Arena& component_arena) noexcept : arena(component_arena)
+{
+}
+
+Entity Registry::create()
+{
+  Entity entity;
+  if (!free_entities.empty())
+  {
+    entity = free_entities.back();
+    free_entities.pop_back();
+  }
+  else
+  {
+    entity = static_cast<Entity>(live.size());
+    live.push_back(0);
+  }
+
+  live[entity] = 1;
+  ++live_count;
+  return entity;
+}
+
+Entity Registry::createSprite(ASGE::Renderer* renderer,
+                              const std::string& texture_file_name,
+                              bool shared)
+{
+  const Entity entity = create();
+  SpriteComponent* sprite =
+    addSprite(entity, renderer, texture_file_name, shared);
+  if (sprite == nullptr)
+  {
+    destroy(entity);
+    return NULL_ENTITY;
+  }
+
+  transforms.add(entity, Transform{});
+  colliders.add(entity,
+                Collider{ sprite->getSprite()->width(),
+                          sprite->getSprite()->height(),
+                          0 });
+  return entity;
+}
+
+SpriteComponent* Registry::addSprite(Entity entity,
+                                     ASGE::Renderer* renderer,
+                                     const std::string& texture_file_name,
+                                     bool shared)
+{
+  auto* sprite = arena.create<SpriteComponent>();
+  if (!sprite->loadSprite(renderer, texture_file_name, shared))
+  {
+    return nullptr;
+  }
+
+  sprites.add(entity, sprite);
+  return sprite;
+}
+
+void Registry::destroy(Entity entity)
+{
+  if (!valid(entity))
+  {
+    return;
+  }
+
+  transforms.remove(entity);
+  velocities.remove(entity);
+  sprites.remove(entity);
+  drawables.remove(entity);
+  colliders.remove(entity);
+  healths.remove(entity);
+  slots.remove(entity);
+
+  live[entity] = 0;
+  --live_count;
+  free_entities.push_back(entity);
+}
+
+bool Registry::valid(Entity entity) const noexcept
+{
+  return entity < live.size() && live[entity];
+}
+
+void Registry::clear() noexcept
+{
+  transforms.clear();
+  velocities.clear();
+  sprites.clear();
+  drawables.clear();
+  colliders.clear();
+  healths.clear();
+  slots.clear();
+
+  live.clear();
+  free_entities.clear();
+  live_count = 0;
+}
+
+void Registry::reserve(size_t count)
+{
+  transforms.reserve(count);
+  velocities.reserve(count);
+  sprites.reserve(count);
+  drawables.reserve(count);
+  colliders.reserve(count);
+  healths.reserve(count);
+  slots.reserve(count);
+
+  live.reserve(count);
+  free_entities.reserve(count);
+}
+
+size_t Registry::size() const noexcept
+{
+  return live_count;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "Components.h"
+#include "Components/SpriteComponent.h"
+#include "ComponentPool.h"
+#include "Entity.h"
+#include "Memory/Arena.h"
+#include <Engine/Renderer.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ *  Creates entities and owns the pools of components attached to them.
+ *  Each type of component lives in its own dense pool, so a system
+ *  iterates exactly the components it needs, reaching any others the
+ *  entity has through an O(1) lookup. Sprite components are created in
+ *  the level's arena; the sprite pool holds pointers to them.
+ *  @see ComponentPool
+ *  @see Arena
+ */
+class Registry
+{
+ public:
+  /**
+   *  @param [in] component_arena Where the sprite components are created
+   */
+  explicit Registry(Arena& component_arena) noexcept;
+  ~Registry() = default;
+
+  Registry(const Registry&) = delete;
+  Registry& operator=(const Registry&) = delete;
+
+  /**
+   *  Creates an entity with no components. The ids of destroyed
+   *  entities are reused.
+   *  @return the new entity
+   */
+  Entity create();
+
+  /**
+   *  Creates an entity with a sprite loaded from the texture, a
+   *  transform at the origin and a collider the size of the texture.
+   *  @param [in] renderer The renderer used to perform the allocations
+   *  @param [in] texture_file_name The file path to the the texture to load
+   *  @param [in] shared Share the sprite with others using the texture
+   *  @return the new entity, or NULL_ENTITY if the sprite failed to load
+   */
+  Entity createSprite(ASGE::Renderer* renderer,
+                      const std::string& texture_file_name,
+                      bool shared);
+
+  /**
+   *  Attaches a sprite component, created in the arena.
+   *  @param [in] entity The owner
+   *  @param [in] renderer The renderer used to perform the allocations
+   *  @param [in] texture_file_name The file path to the the texture to load
+   *  @param [in] shared Share the sprite with others using the texture
+   *  @return the component, or nullptr if the sprite failed to load
+   */
+  SpriteComponent* addSprite(Entity entity,
+                             ASGE::Renderer* renderer,
+                             const std::string& texture_file_name,
+                             bool shared);
+
+  /**
+   *  Removes an entity and all of its components.
+   *  @param [in] entity The entity to destroy
+   */
+  void destroy(Entity entity);
+
+  bool valid(Entity entity) const noexcept;
+
+  /**
+   *  Removes every entity. Sprite components are destroyed when the
+   *  arena is next reset.
+   */
+  void clear() noexcept;
+
+  /**
+   *  Reserves memory for a number of entities up front.
+   *  @param [in] count The number of entities expected
+   */
+  void reserve(size_t count);
+
+  /**
+   *  @return the number of live entities
+   */
+  size_t size() const noexcept;
+
+  ComponentPool<Transform> transforms;
+  ComponentPool<Velocity> velocities;
+  ComponentPool<SpriteComponent*> sprites;
+  ComponentPool<Drawable> drawables;
+  ComponentPool<Collider> colliders;
+  ComponentPool<Health> healths;
+  ComponentPool<FormationSlot> slots;
+
+ private:
+  Arena& arena;
+  std::vector<std::uint8_t> live;
+  std::vector<Entity> free_entities;
+  size_t live_count = 0;
+};
@@ -0,0 +1,116 @@
+#include "SystemSchedule.h"
+#include "Profiler/Profiler.h"
+#include <algorithm>
+#include <utility>
+
+SystemSchedule::SystemSchedule(JobSystem& job_system) noexcept :
+  jobs(job_system)
+{
+}
+
+/**
+ *   @brief   Adds a system to the schedule.
+ *   @details The system is made to follow the earlier systems it
+ *            conflicts with, skipping any that already come before
+ *            one of those, so each system keeps only a few direct
+ *            dependencies.
+ *   @return  void
+ */
+void SystemSchedule::add(const char* name,
+                         std::uint32_t reads,
+                         std::uint32_t writes,
+                         System system)
+{
+  std::vector<size_t> after;
+  for (size_t earlier = systems.size(); earlier > 0; --earlier)
+  {
+    const Entry& entry = systems[earlier - 1];
+    const bool conflicts = (writes & (entry.reads | entry.writes)) != 0 ||
+                           (entry.writes & reads) != 0;
+    if (!conflicts)
+    {
+      continue;
+    }
+
+    const bool implied =
+      std::any_of(after.begin(), after.end(), [&](size_t chosen) {
+        return precedes(earlier - 1, chosen);
+      });
+    if (!implied)
+    {
+      after.push_back(earlier - 1);
+    }
+  }
+
+  systems.push_back(
+    Entry{ name, reads, writes, std::move(system), after, nullptr, 0 });
+}
+
+/**
+ *   @brief   Runs the systems.
+ *   @details In serial, or if the job storage has run out, the systems
+ *            run one after another in the order they were added. In
+ *            parallel every system's job is created and its
+ *            dependencies declared before any is submitted.
+ *   @return  void
+ */
+void SystemSchedule::run(float dt, bool parallel)
+{
+  for (auto& entry : systems)
+  {
+    entry.dt = dt;
+    entry.job = parallel ? jobs.create(&runJob, &entry, 0, 0) : nullptr;
+    parallel = parallel && entry.job != nullptr;
+  }
+
+  if (!parallel)
+  {
+    for (auto& entry : systems)
+    {
+      runJob(&entry, 0, 0);
+    }
+    return;
+  }
+
+  for (auto& entry : systems)
+  {
+    for (auto index : entry.after)
+    {
+      jobs.dependsOn(entry.job, systems[index].job);
+    }
+  }
+
+  for (auto& entry : systems)
+  {
+    jobs.submit(entry.job);
+  }
+
+  for (auto& entry : systems)
+  {
+    jobs.wait(entry.job);
+  }
+}
+
+void SystemSchedule::clear() noexcept
+{
+  systems.clear();
+}
+
+bool SystemSchedule::precedes(size_t earlier, size_t later) const noexcept
+{
+  for (auto index : systems[later].after)
+  {
+    if (index == earlier || precedes(earlier, index))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SystemSchedule::runJob(void* context, size_t /*begin*/, size_t /*end*/)
+{
+  const auto* entry = static_cast<const Entry*>(context);
+  ScopedZone zone(entry->name);
+  entry->system(entry->dt);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "Jobs/JobSystem.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ *  What a system touches. Systems that write something another reads
+ *  or writes conflict, and keep their registration order; the rest
+ *  may run at the same time. Games add their own resources from
+ *  FIRST_GAME_ACCESS up.
+ */
+enum SystemAccess : std::uint32_t
+{
+  TRANSFORM_ACCESS = 1U << 0U,
+  VELOCITY_ACCESS = 1U << 1U,
+  SPRITE_ACCESS = 1U << 2U,
+  COLLIDER_ACCESS = 1U << 3U,
+  HEALTH_ACCESS = 1U << 4U,
+  FORMATION_ACCESS = 1U << 5U,
+  ENTITY_ACCESS = 1U << 6U,
+  FIRST_GAME_ACCESS = 1U << 8U,
+  ALL_ACCESS = 0xFFFFFFFFU
+};
+
+/**
+ *  Runs a fixed list of systems once per tick.
+ *  Each system runs after the earlier systems it conflicts with and
+ *  alongside everything else. When run in parallel every system is a
+ *  job, held back by the jobs of the systems it has to follow, so a
+ *  system starts as soon as what it depends on is done rather than
+ *  waiting on a whole stage. Systems can split their own work into
+ *  more jobs on the same job system.
+ *  @see JobSystem
+ */
+class SystemSchedule
+{
+ public:
+  using System = std::function<void(float)>;
+
+  /**
+   *  @param [in] job_system The job system the systems run on
+   */
+  explicit SystemSchedule(JobSystem& job_system) noexcept;
+  ~SystemSchedule() = default;
+
+  SystemSchedule(const SystemSchedule&) = delete;
+  SystemSchedule& operator=(const SystemSchedule&) = delete;
+
+  /**
+   *  Adds a system after those already added.
+   *  @param [in] name The profiler zone the system runs in
+   *  @param [in] reads The resources it reads
+   *  @param [in] writes The resources it writes
+   *  @param [in] system The system itself, given the tick length
+   */
+  void add(const char* name,
+           std::uint32_t reads,
+           std::uint32_t writes,
+           System system);
+
+  /**
+   *  Runs every system and waits for them all.
+   *  @param [in] dt The length of the tick, in seconds
+   *  @param [in] parallel Run systems that do not conflict side by side
+   */
+  void run(float dt, bool parallel);
+
+  void clear() noexcept;
+
+ private:
+  struct Entry
+  {
+    const char* name;
+    std::uint32_t reads;
+    std::uint32_t writes;
+    System system;
+    std::vector<size_t> after;
+    JobSystem::Job* job;
+    float dt;
+  };
+
+  bool precedes(size_t earlier, size_t later) const noexcept;
+  static void runJob(void* context, size_t begin, size_t end);
+
+  JobSystem& jobs;
+  std::vector<Entry> systems;
+};
@@ -0,0 +1,200 @@
+#include "Systems.h"
+
+Box PackedColliders::box(size_t index) const noexcept
+{
+  return Box{ x[index], y[index], width[index], height[index] };
+}
+
+size_t PackedColliders::size() const noexcept
+{
+  return entity.size();
+}
+
+void PackedColliders::reserve(size_t count)
+{
+  x.reserve(count);
+  y.reserve(count);
+  width.reserve(count);
+  height.reserve(count);
+  entity.reserve(count);
+  alive.reserve(count);
+}
+
+void PackedColliders::resize(size_t count)
+{
+  x.resize(count);
+  y.resize(count);
+  width.resize(count);
+  height.resize(count);
+  entity.resize(count);
+  alive.resize(count);
+}
+
+void PackedColliders::clear() noexcept
+{
+  x.clear();
+  y.clear();
+  width.clear();
+  height.clear();
+  entity.clear();
+  alive.clear();
+}
+
+void storePositions(Registry& registry, JobSystem& jobs)
+{
+  Transform* transform = registry.transforms.data();
+
+  auto store = [transform](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+    {
+      transform[i].prev_x = transform[i].x;
+      transform[i].prev_y = transform[i].y;
+    }
+  };
+  jobs.parallelFor(registry.transforms.size(), SYSTEM_GRAIN, store);
+}
+
+/**
+ *   @brief   Moves every entity with a velocity.
+ *   @details Walks the velocity pool, which only holds the entities
+ *            that move, and looks each one's transform up. Entities
+ *            own their transforms, so the chunks never write the same
+ *            one.
+ *   @return  void
+ */
+void integrate(Registry& registry, float dt, JobSystem& jobs)
+{
+  const Velocity* velocity = registry.velocities.data();
+  const Entity* entities = registry.velocities.entities().data();
+
+  auto move = [&registry, velocity, entities, dt](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+    {
+      Transform* transform = registry.transforms.find(entities[i]);
+      if (transform != nullptr)
+      {
+        transform->x += velocity[i].x * dt;
+        transform->y += velocity[i].y * dt;
+      }
+    }
+  };
+  jobs.parallelFor(registry.velocities.size(), SYSTEM_GRAIN, move);
+}
+
+/**
+ *   @brief   Packs the colliders of a formation's aliens.
+ *   @details The arrays are sized up front so each chunk writes its
+ *            own part of them. Each alien's box comes from its slot.
+ *   @return  void
+ */
+void packFormation(const Registry& registry,
+                   const Formation& formation,
+                   PackedColliders& packed,
+                   JobSystem& jobs)
+{
+  const FormationSlot* slot = registry.slots.data();
+  const auto& entities = registry.slots.entities();
+  packed.resize(entities.size());
+
+  auto pack = [slot, &entities, &formation, &packed](size_t begin,
+                                                     size_t end) {
+    for (size_t i = begin; i < end; ++i)
+    {
+      const Box box = formation.slotBox(slot[i].column, slot[i].row);
+      packed.x[i] = box.x;
+      packed.y[i] = box.y;
+      packed.width[i] = box.width;
+      packed.height[i] = box.height;
+      packed.entity[i] = entities[i];
+      packed.alive[i] = 1;
+    }
+  };
+  jobs.parallelFor(entities.size(), SYSTEM_GRAIN, pack);
+}
+
+Box colliderBox(const Registry& registry, Entity entity) noexcept
+{
+  const Transform& transform = registry.transforms.get(entity);
+  const Collider& collider = registry.colliders.get(entity);
+  return Box{ transform.x, transform.y, collider.width, collider.height };
+}
+
+bool applyDamage(Registry& registry, Entity entity, int damage)
+{
+  Health* health = registry.healths.find(entity);
+  if (health != nullptr)
+  {
+    health->hit_points -= damage;
+    if (health->hit_points > 0)
+    {
+      return false;
+    }
+  }
+
+  registry.destroy(entity);
+  return true;
+}
+
+/**
+ *   @brief   Copies every drawable entity into a frame.
+ *   @details Positions are interpolated here rather than when drawn, so
+ *            the packet holds exactly what is shown. Entities without a
+ *            transform, such as backdrops that are positioned once, are
+ *            left for the game to add.
+ *   @return  void
+ */
+void writeSprites(const Registry& registry, float alpha, FramePacket& packet)
+{
+  const Drawable* drawable = registry.drawables.data();
+  const auto& entities = registry.drawables.entities();
+
+  for (size_t i = 0; i < entities.size(); ++i)
+  {
+    const Transform* transform = registry.transforms.find(entities[i]);
+    if (transform == nullptr || drawable[i].fixed)
+    {
+      continue;
+    }
+
+    packet.addSprite(
+      drawable[i].sprite,
+      transform->prev_x + (transform->x - transform->prev_x) * alpha,
+      transform->prev_y + (transform->y - transform->prev_y) * alpha,
+      drawable[i].z);
+  }
+}
+
+void writeStaticSprites(const Registry& registry, FramePacket& packet)
+{
+  const Drawable* drawable = registry.drawables.data();
+  const auto& entities = registry.drawables.entities();
+
+  for (size_t i = 0; i < entities.size(); ++i)
+  {
+    const Transform* transform = registry.transforms.find(entities[i]);
+    if (transform != nullptr && drawable[i].fixed)
+    {
+      packet.addStaticSprite(
+        drawable[i].sprite, transform->x, transform->y, drawable[i].z);
+    }
+  }
+}
+
+void writeFormation(const Registry& registry,
+                    const Formation& formation,
+                    float alpha,
+                    FramePacket& packet)
+{
+  for (const Entity entity : registry.slots.entities())
+  {
+    const Drawable* drawable = registry.drawables.find(entity);
+    if (drawable == nullptr)
+    {
+      continue;
+    }
+
+    const FormationSlot& slot = registry.slots.get(entity);
+    const Box box = formation.slotBox(slot.column, slot.row, alpha);
+    packet.addSprite(drawable->sprite, box.x, box.y, drawable->z);
+  }
+}
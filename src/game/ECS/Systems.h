@@ -0,0 +1,113 @@
+#pragma once
+#include "Jobs/JobSystem.h"
+#include "Movement/Formation.h"
+#include "Physics/Collision.h"
+#include "Registry.h"
+#include "Rendering/FramePacket.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ *  Entities handed to a job at a time by the systems that split their
+ *  work between threads. Smaller pools are processed in one piece.
+ */
+constexpr size_t SYSTEM_GRAIN = 1024;
+
+/**
+ *  The colliders of a group of entities, copied out into separate x, y, width
+ *  and height arrays so the overlap kernel can sweep them with vector
+ *  loads. Packed once per tick, after everything has moved.
+ *  @see overlapMask
+ */
+struct PackedColliders
+{
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> width;
+  std::vector<float> height;
+  std::vector<Entity> entity;
+  std::vector<std::uint8_t> alive;
+
+  Box box(size_t index) const noexcept;
+  size_t size() const noexcept;
+  void reserve(size_t count);
+  void resize(size_t count);
+  void clear() noexcept;
+};
+
+/**
+ *  Records every position as the previous tick's, ready for the next
+ *  tick to move them.
+ *  @param [in] registry The entities to update
+ *  @param [in] jobs The job system to split the work over
+ */
+void storePositions(Registry& registry, JobSystem& jobs);
+
+/**
+ *  Moves every entity with a velocity and a transform.
+ *  @param [in] registry The entities to move
+ *  @param [in] dt The length of the tick, in seconds
+ *  @param [in] jobs The job system to split the work over
+ */
+void integrate(Registry& registry, float dt, JobSystem& jobs);
+
+/**
+ *  Copies the colliders of the aliens in a formation into packed arrays,
+ *  in the order of the formation slot pool.
+ *  @param [in] registry The aliens' registry
+ *  @param [in] formation The formation the aliens hold slots in
+ *  @param [out] packed The packed colliders, resized to fit
+ *  @param [in] jobs The job system to split the work over
+ */
+void packFormation(const Registry& registry,
+                   const Formation& formation,
+                   PackedColliders& packed,
+                   JobSystem& jobs);
+
+/**
+ *  The bounds of an entity with a transform and a collider.
+ *  @param [in] registry The entity's registry
+ *  @param [in] entity The entity
+ *  @return the entity's position and dimensions
+ */
+Box colliderBox(const Registry& registry, Entity entity) noexcept;
+
+/**
+ *  Takes hit points from an entity, destroying it if none are left.
+ *  Entities without health are destroyed by any damage.
+ *  @param [in] registry The entity's registry
+ *  @param [in] entity The entity that was hit
+ *  @param [in] damage The hit points to take
+ *  @return true if the entity was destroyed
+ */
+bool applyDamage(Registry& registry, Entity entity, int damage);
+
+/**
+ *  Adds every drawable entity with a transform that is not fixed to a
+ *  frame packet, interpolated between the previous and current tick.
+ *  @param [in] registry The entities to draw
+ *  @param [in] alpha How far the frame is towards the current tick
+ *  @param [out] packet The frame the draws are added to
+ */
+void writeSprites(const Registry& registry, float alpha, FramePacket& packet);
+
+/**
+ *  Adds every fixed drawable entity with a transform to a frame packet's
+ *  static layer.
+ *  @param [in] registry The entities to draw
+ *  @param [out] packet The frame the draws are added to
+ */
+void writeStaticSprites(const Registry& registry, FramePacket& packet);
+
+/**
+ *  Adds every drawable alien in a formation to a frame packet,
+ *  interpolated between the previous and current tick.
+ *  @param [in] registry The aliens' registry
+ *  @param [in] formation The formation the aliens hold slots in
+ *  @param [in] alpha How far the frame is towards the current tick
+ *  @param [out] packet The frame the draws are added to
+ */
+void writeFormation(const Registry& registry,
+                    const Formation& formation,
+                    float alpha,
+                    FramePacket& packet);
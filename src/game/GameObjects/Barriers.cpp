@@ -0,0 +1,304 @@
+#include "Barriers.h"
+#include "Physics/OverlapKernel.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr size_t Barriers::COLUMNS;
+constexpr size_t Barriers::ROWS;
+constexpr size_t Barriers::MAX_DRAWS;
+constexpr size_t Barriers::MAX_RUNS;
+
+namespace
+{
+  static_assert(Barriers::COLUMNS < 64, "a barrier row must fit a word");
+  static_assert(Barriers::ROWS <= 32, "dirty rows must fit a word");
+
+  const std::uint64_t ROW_MASK = (1ULL << Barriers::COLUMNS) - 1;
+  const std::uint32_t ALL_ROWS =
+    static_cast<std::uint32_t>((1ULL << Barriers::ROWS) - 1);
+
+  // a shot's crater, widest where it strikes and narrowing inwards
+  const std::uint64_t CRATER[] = { 0x1F, 0x1F, 0x0E, 0x04 };
+  const size_t CRATER_DEPTH = sizeof(CRATER) / sizeof(CRATER[0]);
+  const size_t CRATER_CENTRE = 2;
+
+  const size_t BEVEL = 4;
+  const size_t ARCH_HEIGHT = 4;
+  const size_t ARCH_FIRST = 7;
+  const size_t ARCH_LAST = 14;
+
+  std::uint64_t columnMask(size_t first, size_t last) noexcept
+  {
+    return ((1ULL << (last + 1)) - 1) & ~((1ULL << first) - 1);
+  }
+
+  /**
+   *  A row of the classic barrier: a block with its top corners
+   *  bevelled and an arch cut out underneath.
+   */
+  std::uint64_t shapeRow(size_t row) noexcept
+  {
+    std::uint64_t mask = ROW_MASK;
+    if (row < BEVEL)
+    {
+      const size_t bevel = BEVEL - row;
+      mask &= ~columnMask(0, bevel - 1);
+      mask &= ~columnMask(Barriers::COLUMNS - bevel, Barriers::COLUMNS - 1);
+    }
+
+    if (row + ARCH_HEIGHT >= Barriers::ROWS)
+    {
+      mask &= ~columnMask(ARCH_FIRST, ARCH_LAST);
+    }
+    else if (row + ARCH_HEIGHT + 1 == Barriers::ROWS)
+    {
+      mask &= ~columnMask(ARCH_FIRST + 1, ARCH_LAST - 1);
+    }
+
+    return mask;
+  }
+
+  std::uint64_t craterRow(size_t depth, size_t column) noexcept
+  {
+    const std::uint64_t crater =
+      column >= CRATER_CENTRE ? CRATER[depth] << (column - CRATER_CENTRE)
+                              : CRATER[depth] >> (CRATER_CENTRE - column);
+    return crater & ROW_MASK;
+  }
+}
+
+void Barriers::init(size_t count, float cell_size)
+{
+  cells.resize(count * ROWS);
+  for (size_t barrier = 0; barrier < count; ++barrier)
+  {
+    for (size_t row = 0; row < ROWS; ++row)
+    {
+      cells[barrier * ROWS + row] = shapeRow(row);
+    }
+  }
+
+  dirty.assign(count, ALL_ROWS);
+  runs.resize(count * ROWS * MAX_RUNS);
+  run_counts.assign(count * ROWS, 0);
+  left.assign(count, 0.0F);
+  top.assign(count, 0.0F);
+  cell = cell_size;
+}
+
+void Barriers::place(size_t barrier, float x, float y) noexcept
+{
+  left[barrier] = x;
+  top[barrier] = y;
+}
+
+/**
+ *   @brief   Shoots a barrier
+ *   @details The rows the shot covers are searched in the direction it
+ *            travels for the first with a live cell under it. The crater
+ *            is centred on the middle of the shot when that cell is
+ *            live, otherwise on the first live cell, and is blasted
+ *            into the barrier a row at a time.
+ *   @return  True if the shot hit.
+ */
+bool Barriers::shoot(size_t barrier, const Box& shot, bool downwards) noexcept
+{
+  CellRange range;
+  if (!cellRange(barrier, shot, range))
+  {
+    return false;
+  }
+
+  const size_t rows = range.last_row - range.first_row + 1;
+  for (size_t step = 0; step < rows; ++step)
+  {
+    const size_t row =
+      downwards ? range.first_row + step : range.last_row - step;
+    const std::uint64_t hits = cells[barrier * ROWS + row] & range.columns;
+    if (hits == 0)
+    {
+      continue;
+    }
+
+    const size_t centre = (range.first_column + range.last_column) / 2;
+    const size_t column = hits & (1ULL << centre) ? centre : lowestBit(hits);
+    for (size_t depth = 0; depth < CRATER_DEPTH; ++depth)
+    {
+      if (downwards ? row + depth >= ROWS : depth > row)
+      {
+        break;
+      }
+
+      erode(barrier,
+            downwards ? row + depth : row - depth,
+            craterRow(depth, column));
+    }
+    return true;
+  }
+
+  return false;
+}
+
+bool Barriers::crush(size_t barrier, const Box& box) noexcept
+{
+  CellRange range;
+  if (!cellRange(barrier, box, range))
+  {
+    return false;
+  }
+
+  bool crushed = false;
+  for (size_t row = range.first_row; row <= range.last_row; ++row)
+  {
+    crushed |= (cells[barrier * ROWS + row] & range.columns) != 0;
+    erode(barrier, row, range.columns);
+  }
+  return crushed;
+}
+
+/**
+ *   @brief   Draws the barriers
+ *   @details Runs are found a word at a time: the lowest set bit starts
+ *            a run and the lowest clear bit above it ends it.
+ *   @return  void
+ */
+void Barriers::writeStaticSprites(std::uint16_t sprite,
+                                  std::int16_t z,
+                                  FramePacket& packet)
+{
+  for (size_t barrier = 0; barrier < size(); ++barrier)
+  {
+    for (size_t row = 0; row < ROWS; ++row)
+    {
+      if (dirty[barrier] & (1U << row))
+      {
+        buildRuns(barrier, row);
+      }
+
+      const size_t slot = barrier * ROWS + row;
+      for (size_t i = 0; i < run_counts[slot]; ++i)
+      {
+        const Run& run = runs[slot * MAX_RUNS + i];
+
+        SpriteDraw draw;
+        draw.x = left[barrier] + static_cast<float>(run.first) * cell;
+        draw.y = top[barrier] + static_cast<float>(row) * cell;
+        draw.width = static_cast<float>(run.length) * cell;
+        draw.height = cell;
+        draw.sprite = sprite;
+        draw.z = z;
+        packet.addStaticSprite(draw);
+      }
+    }
+
+    dirty[barrier] = 0;
+  }
+}
+
+Box Barriers::box(size_t barrier) const noexcept
+{
+  return Box{ left[barrier],
+              top[barrier],
+              static_cast<float>(COLUMNS) * cell,
+              static_cast<float>(ROWS) * cell };
+}
+
+bool Barriers::destroyed(size_t barrier) const noexcept
+{
+  std::uint64_t live = 0;
+  for (size_t row = 0; row < ROWS; ++row)
+  {
+    live |= cells[barrier * ROWS + row];
+  }
+  return live == 0;
+}
+
+size_t Barriers::size() const noexcept
+{
+  return left.size();
+}
+
+void Barriers::writeState(SnapshotWriter& out) const
+{
+  out.writeArray(cells.data(), cells.size());
+  out.writeArray(left.data(), left.size());
+  out.writeArray(top.data(), top.size());
+}
+
+/**
+ *   @brief   Restores the live cells and where every barrier is
+ *   @details The runs are not saved, so every row is marked to have its
+ *            runs rebuilt the next time the barriers are drawn.
+ *   @return  True if the snapshot held as many barriers.
+ */
+bool Barriers::readState(SnapshotReader& in) noexcept
+{
+  if (!in.readArray(cells.data(), cells.size()) ||
+      !in.readArray(left.data(), left.size()) ||
+      !in.readArray(top.data(), top.size()))
+  {
+    return false;
+  }
+
+  std::fill(dirty.begin(), dirty.end(), ALL_ROWS);
+  return true;
+}
+
+/**
+ *   @brief   Finds the cells under a box
+ *   @return  True if the box covers any of the barrier's cells.
+ */
+bool Barriers::cellRange(size_t barrier,
+                         const Box& box,
+                         CellRange& range) const noexcept
+{
+  const float x0 = (box.x - left[barrier]) / cell;
+  const float x1 = (box.x + box.width - left[barrier]) / cell;
+  const float y0 = (box.y - top[barrier]) / cell;
+  const float y1 = (box.y + box.height - top[barrier]) / cell;
+
+  const auto columns = static_cast<float>(COLUMNS);
+  const auto rows = static_cast<float>(ROWS);
+  if (x1 <= 0 || y1 <= 0 || x0 >= columns || y0 >= rows)
+  {
+    return false;
+  }
+
+  range.first_column = x0 > 0 ? static_cast<size_t>(x0) : 0;
+  range.last_column =
+    std::min(COLUMNS, static_cast<size_t>(std::ceil(x1))) - 1;
+  range.first_row = y0 > 0 ? static_cast<size_t>(y0) : 0;
+  range.last_row = std::min(ROWS, static_cast<size_t>(std::ceil(y1))) - 1;
+  range.columns = columnMask(range.first_column, range.last_column);
+  return true;
+}
+
+void Barriers::erode(size_t barrier, size_t row, std::uint64_t mask) noexcept
+{
+  std::uint64_t& word = cells[barrier * ROWS + row];
+  if (word & mask)
+  {
+    word &= ~mask;
+    dirty[barrier] |= 1U << row;
+  }
+}
+
+void Barriers::buildRuns(size_t barrier, size_t row) noexcept
+{
+  const size_t slot = barrier * ROWS + row;
+  Run* out = &runs[slot * MAX_RUNS];
+
+  std::uint8_t count = 0;
+  std::uint64_t word = cells[slot];
+  while (word != 0)
+  {
+    const size_t first = lowestBit(word);
+    const size_t length = lowestBit(~(word >> first));
+    out[count].first = static_cast<std::uint8_t>(first);
+    out[count].length = static_cast<std::uint8_t>(length);
+    ++count;
+    word &= ~columnMask(first, first + length - 1);
+  }
+
+  run_counts[slot] = count;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include "Physics/Collision.h"
+#include "Rendering/FramePacket.h"
+#include "Replay/Snapshot.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ *  Destructible barriers, each a grid of cells packed one row to a word.
+ *  A shot or an alien only has to look at the rows it covers, and a row
+ *  is tested and eroded with a single mask, so a barrier costs the same
+ *  to hit however finely it is cut up. Barriers are drawn as runs of
+ *  live cells, one sprite per run, and a row's runs are only rebuilt
+ *  once it has been eroded.
+ */
+class Barriers
+{
+ public:
+  static constexpr size_t COLUMNS = 22;
+  static constexpr size_t ROWS = 16;
+
+  /** The most runs a barrier can be drawn with. */
+  static constexpr size_t MAX_DRAWS = ROWS * (COLUMNS + 1) / 2;
+
+  Barriers() = default;
+  ~Barriers() = default;
+
+  Barriers(const Barriers&) = delete;
+  Barriers& operator=(const Barriers&) = delete;
+
+  /**
+   *  Creates a number of barriers at the origin, every one intact.
+   *  @param [in] count The number of barriers
+   *  @param [in] cell_size The width and height of a cell
+   */
+  void init(size_t count, float cell_size);
+
+  /**
+   *  Moves a barrier.
+   *  @param [in] barrier The barrier to move
+   *  @param [in] x The left of the barrier
+   *  @param [in] y The top of the barrier
+   */
+  void place(size_t barrier, float x, float y) noexcept;
+
+  /**
+   *  Blasts a crater in a barrier where a shot first reaches a live cell.
+   *  @param [in] barrier The barrier shot at
+   *  @param [in] shot The shot's bounds
+   *  @param [in] downwards Whether the shot is travelling down the screen
+   *  @return true if the shot hit a live cell and is spent
+   */
+  bool shoot(size_t barrier, const Box& shot, bool downwards) noexcept;
+
+  /**
+   *  Clears every cell under a box.
+   *  @param [in] barrier The barrier crushed
+   *  @param [in] box The bounds of what is crushing it
+   *  @return true if any live cell was cleared
+   */
+  bool crush(size_t barrier, const Box& box) noexcept;
+
+  /**
+   *  Adds the runs of live cells in every barrier to a frame packet's
+   *  static layer, rebuilding the runs of any rows eroded since the last
+   *  call.
+   *  @param [in] sprite The sprite id to draw the runs with
+   *  @param [in] z The runs' depth
+   *  @param [out] packet The frame the draws are added to
+   */
+  void writeStaticSprites(std::uint16_t sprite,
+                          std::int16_t z,
+                          FramePacket& packet);
+
+  /**
+   *  @return the bounds of a barrier, whether or not it has cells left
+   */
+  Box box(size_t barrier) const noexcept;
+
+  /**
+   *  @return true if every cell of the barrier has been cleared
+   */
+  bool destroyed(size_t barrier) const noexcept;
+
+  size_t size() const noexcept;
+
+  /**
+   *  Saves the live cells and where every barrier is.
+   *  @param [in] out The snapshot written to
+   */
+  void writeState(SnapshotWriter& out) const;
+
+  /**
+   *  Restores what writeState saved, marking every row to be redrawn.
+   *  @param [in] in The snapshot read from
+   *  @return false if the snapshot holds another number of barriers
+   */
+  bool readState(SnapshotReader& in) noexcept;
+
+ private:
+  struct Run
+  {
+    std::uint8_t first = 0;
+    std::uint8_t length = 0;
+  };
+
+  /** The cells a box covers, inclusive. */
+  struct CellRange
+  {
+    size_t first_row = 0;
+    size_t last_row = 0;
+    size_t first_column = 0;
+    size_t last_column = 0;
+    std::uint64_t columns = 0; /**< The covered columns as a row mask. */
+  };
+
+  static constexpr size_t MAX_RUNS = (COLUMNS + 1) / 2;
+
+  bool cellRange(size_t barrier, const Box& box, CellRange& range) const
+    noexcept;
+  void erode(size_t barrier, size_t row, std::uint64_t mask) noexcept;
+  void buildRuns(size_t barrier, size_t row) noexcept;
+
+  std::vector<std::uint64_t> cells; /**< ROWS words per barrier. */
+  std::vector<std::uint32_t> dirty; /**< One bit per row per barrier. */
+  std::vector<Run> runs;            /**< MAX_RUNS per row. */
+  std::vector<std::uint8_t> run_counts;
+  std::vector<float> left;
+  std::vector<float> top;
+  float cell = 1;
+};
@@ -1,43 +1,56 @@
 #include "GameObject.h"
 #include <Engine/Renderer.h>
 
-GameObject::~GameObject()
+bool GameObject::create(Registry& object_registry,
+                        ASGE::Renderer* renderer,
+                        const std::string& texture_file_name)
 {
-  free();
-}
-
-bool GameObject::addSpriteComponent(ASGE::Renderer* renderer,
-                                    const std::string& texture_file_name)
-{
-  free();
-
-  sprite_component = new SpriteComponent();
-  if (sprite_component->loadSprite(renderer, texture_file_name))
+  registry = &object_registry;
+  id = registry->createSprite(renderer, texture_file_name, false);
+  if (id == NULL_ENTITY)
   {
-    return true;
+    return false;
   }
 
-  free();
-  return false;
+  registry->velocities.add(id, Velocity{});
+  return true;
 }
 
-void GameObject::free()
+SpriteComponent* GameObject::spriteComponent()
 {
-  delete sprite_component;
-  sprite_component = nullptr;
+  SpriteComponent** sprite =
+    registry != nullptr ? registry->sprites.find(id) : nullptr;
+  return sprite != nullptr ? *sprite : nullptr;
 }
 
-SpriteComponent* GameObject::spriteComponent()
+Transform* GameObject::transform()
+{
+  return registry != nullptr ? registry->transforms.find(id) : nullptr;
+}
+
+Vector2 GameObject::getVelocity() const
 {
-  return sprite_component;
+  if (registry == nullptr || !registry->velocities.contains(id))
+  {
+    return Vector2{ 0, 0 };
+  }
+
+  const Velocity& velocity = registry->velocities.get(id);
+  return Vector2{ velocity.x, velocity.y };
 }
 
-const Vector2& GameObject::getVelocity() const
+void GameObject::setVelocity(const Vector2& new_velocity)
 {
-  return velocity;
+  Velocity* velocity =
+    registry != nullptr ? registry->velocities.find(id) : nullptr;
+  if (velocity != nullptr)
+  {
+    velocity->x = new_velocity.x;
+    velocity->y = new_velocity.y;
+  }
 }
 
-void GameObject::setVelocity(const Vector2& velocity)
+Entity GameObject::entity() const noexcept
 {
-  GameObject::velocity = velocity;
+  return id;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Components/SpriteComponent.h"
+#include "ECS/Registry.h"
 #include "Utility/Vector2.h"
 #include <Engine/Renderer.h>
 #include <Engine/Sprite.h>
@@ -7,35 +8,35 @@
 
 /**
  *  Objects used throughout the game.
- *  Provides a nice solid base class for objects in this game world.
- *  They currently support only sprite components, but this could easily
- *  be extended to include things like rigid bodies or input systems.
- *  @see SpriteComponent
+ *  A handle to one entity in a Registry, for the one-off objects the
+ *  game talks to directly. The object holds no state of its own;
+ *  its components live in the registry's pools, where the systems
+ *  iterate them alongside every other entity's.
+ *  @see Registry
  */
 class GameObject
 {
  public:
   /**
-   *  Default constructor.
+   *  Default constructor. The object refers to no entity until it is
+   *  created.
    */
   GameObject() = default;
 
   /**
-   *  Destructor. Frees dynamic memory.
-   */
-  ~GameObject();
-
-  /**
-   *  Allocates and attaches a sprite component to the object.
+   *  Creates the object's entity, with a transform, a velocity and a
+   *  sprite whose collider matches the texture.
    *  Part of this process will attempt to load a texture file.
-   *  If this fails this function will return false and the memory
-   *  allocated, freed.
+   *  If this fails this function will return false and the entity
+   *  destroyed.
+   *  @param [in] registry The registry to create the entity in
    *  @param [in] renderer The renderer used to perform the allocations
    *  @param [in] texture_file_name The file path to the the texture to load
-   *  @return true if the component is successfully added
+   *  @return true if the object was created
    */
-  bool addSpriteComponent(ASGE::Renderer* renderer,
-                          const std::string& texture_file_name);
+  bool create(Registry& registry,
+              ASGE::Renderer* renderer,
+              const std::string& texture_file_name);
 
   /**
    *  Returns the sprite componenent.
@@ -45,13 +46,17 @@ class GameObject
    */
   SpriteComponent* spriteComponent();
 
-  const Vector2& getVelocity() const;
-  void setVelocity(const Vector2& velocity);
+  /**
+   *  @return a pointer to the object's transform (if any)
+   */
+  Transform* transform();
+
+  Vector2 getVelocity() const;
+  void setVelocity(const Vector2& new_velocity);
 
-  bool visibility = false;
+  Entity entity() const noexcept;
 
  private:
-  void free();
-  SpriteComponent* sprite_component = nullptr;
-  Vector2 velocity = Vector2(0, 0);
+  Registry* registry = nullptr;
+  Entity id = NULL_ENTITY;
 };
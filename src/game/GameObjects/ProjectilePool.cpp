@@ -0,0 +1,215 @@
+#include "ProjectilePool.h"
+#include <algorithm>
+
+/**
+ *   @brief   Allocates every slot up front.
+ *   @details The free list is filled in reverse so that slots are
+ *            handed out from the front of the arrays first.
+ *   @return  True if the sprite was loaded.
+ */
+bool ProjectilePool::init(ASGE::Renderer* renderer,
+                          const std::string& texture_file_name,
+                          size_t capacity)
+{
+  if (!sprite.loadSprite(renderer, texture_file_name, true))
+  {
+    return false;
+  }
+
+  projectile_width = sprite.getSprite()->width();
+  projectile_height = sprite.getSprite()->height();
+
+  x.assign(capacity, 0);
+  y.assign(capacity, 0);
+  prev_x.assign(capacity, 0);
+  prev_y.assign(capacity, 0);
+  vx.assign(capacity, 0);
+  vy.assign(capacity, 0);
+  active_index.assign(capacity, 0);
+
+  active.clear();
+  active.reserve(capacity);
+  free_slots.clear();
+  free_slots.reserve(capacity);
+  for (size_t slot = capacity; slot > 0; --slot)
+  {
+    free_slots.push_back(static_cast<std::uint32_t>(slot - 1));
+  }
+
+  return true;
+}
+
+int ProjectilePool::acquire(float pos_x,
+                            float pos_y,
+                            float vel_x,
+                            float vel_y) noexcept
+{
+  if (free_slots.empty())
+  {
+    return -1;
+  }
+
+  const std::uint32_t slot = free_slots.back();
+  free_slots.pop_back();
+
+  x[slot] = prev_x[slot] = pos_x;
+  y[slot] = prev_y[slot] = pos_y;
+  vx[slot] = vel_x;
+  vy[slot] = vel_y;
+
+  active_index[slot] = static_cast<std::uint32_t>(active.size());
+  active.push_back(slot);
+  return static_cast<int>(slot);
+}
+
+void ProjectilePool::release(std::uint32_t slot) noexcept
+{
+  const std::uint32_t index = active_index[slot];
+  const std::uint32_t last = active.back();
+
+  active[index] = last;
+  active_index[last] = index;
+  active.pop_back();
+
+  free_slots.push_back(slot);
+}
+
+void ProjectilePool::clear() noexcept
+{
+  while (!active.empty())
+  {
+    release(active.back());
+  }
+}
+
+void ProjectilePool::advance(float dt, size_t first, size_t last) noexcept
+{
+  for (size_t i = first; i < last; ++i)
+  {
+    const std::uint32_t slot = active[i];
+    x[slot] += vx[slot] * dt;
+    y[slot] += vy[slot] * dt;
+  }
+}
+
+void ProjectilePool::cull(const Box& bounds) noexcept
+{
+  for (size_t i = active.size(); i > 0; --i)
+  {
+    const std::uint32_t slot = active[i - 1];
+    if (!overlaps(box(slot), bounds))
+    {
+      release(slot);
+    }
+  }
+}
+
+void ProjectilePool::storePositions() noexcept
+{
+  for (auto slot : active)
+  {
+    prev_x[slot] = x[slot];
+    prev_y[slot] = y[slot];
+  }
+}
+
+void ProjectilePool::writeSprites(float alpha,
+                                  std::uint16_t sprite_id,
+                                  std::int16_t z,
+                                  FramePacket& packet) const
+{
+  for (const std::uint32_t slot : active)
+  {
+    packet.addSprite(sprite_id,
+                     prev_x[slot] + (x[slot] - prev_x[slot]) * alpha,
+                     prev_y[slot] + (y[slot] - prev_y[slot]) * alpha,
+                     z);
+  }
+}
+
+Box ProjectilePool::box(std::uint32_t slot) const noexcept
+{
+  return Box{ x[slot], y[slot], projectile_width, projectile_height };
+}
+
+const std::vector<std::uint32_t>& ProjectilePool::live() const noexcept
+{
+  return active;
+}
+
+void ProjectilePool::writeState(SnapshotWriter& out) const
+{
+  out.writeArray(active.data(), active.size());
+  out.writeArray(free_slots.data(), free_slots.size());
+  for (const std::uint32_t slot : active)
+  {
+    out.write(x[slot]);
+    out.write(y[slot]);
+    out.write(prev_x[slot]);
+    out.write(prev_y[slot]);
+    out.write(vx[slot]);
+    out.write(vy[slot]);
+  }
+}
+
+/**
+ *   @brief   Restores the live projectiles
+ *   @details Every slot must be on exactly one of the two lists, or the
+ *            pool would hand the same slot out twice. A snapshot that
+ *            fails to restore leaves the pool empty rather than broken.
+ *   @return  True if the pool was restored.
+ */
+bool ProjectilePool::readState(SnapshotReader& in)
+{
+  const size_t slots = x.size();
+  bool valid = in.readArray(active, slots) &&
+               in.readArray(free_slots, slots) &&
+               active.size() + free_slots.size() == slots;
+
+  // mark every slot seen, using active_index as scratch
+  std::fill(active_index.begin(), active_index.end(), 0);
+  for (size_t i = 0; valid && i < slots; ++i)
+  {
+    const std::uint32_t slot =
+      i < active.size() ? active[i] : free_slots[i - active.size()];
+    valid = slot < slots && active_index[slot] == 0;
+    if (valid)
+    {
+      active_index[slot] = 1;
+    }
+  }
+
+  for (size_t index = 0; valid && index < active.size(); ++index)
+  {
+    const std::uint32_t slot = active[index];
+    active_index[slot] = static_cast<std::uint32_t>(index);
+    valid = in.read(x[slot]) && in.read(y[slot]) && in.read(prev_x[slot]) &&
+            in.read(prev_y[slot]) && in.read(vx[slot]) && in.read(vy[slot]);
+  }
+
+  if (!valid)
+  {
+    active.clear();
+    free_slots.clear();
+    for (size_t slot = slots; slot > 0; --slot)
+    {
+      free_slots.push_back(static_cast<std::uint32_t>(slot - 1));
+    }
+  }
+  return valid;
+}
+
+size_t ProjectilePool::capacity() const noexcept
+{
+  return x.size();
+}
+
+float ProjectilePool::width() const noexcept
+{
+  return projectile_width;
+}
+
+float ProjectilePool::height() const noexcept
+{
+  return projectile_height;
+}
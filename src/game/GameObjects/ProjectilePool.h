@@ -0,0 +1,131 @@
+#pragma once
+#include "Components/SpriteComponent.h"
+#include "Physics/Collision.h"
+#include "Rendering/FramePacket.h"
+#include "Replay/Snapshot.h"
+#include <Engine/Renderer.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ *  Fixed capacity pool of identical projectiles.
+ *  Every slot is allocated when the pool is created. Free slots are kept
+ *  on a free list and live ones in a dense active list, so firing and
+ *  expiring a shot are both O(1) and the per tick loops only visit the
+ *  shots that are in flight. All the projectiles share one sprite.
+ */
+class ProjectilePool
+{
+ public:
+  ProjectilePool() = default;
+  ~ProjectilePool() = default;
+
+  ProjectilePool(const ProjectilePool&) = delete;
+  ProjectilePool& operator=(const ProjectilePool&) = delete;
+
+  /**
+   *  Allocates the pool and loads the projectile's sprite.
+   *  @param [in] renderer The renderer used to perform the allocations
+   *  @param [in] texture_file_name The file path to the the texture to load
+   *  @param [in] capacity The most projectiles that can be live at once
+   *  @return true if the sprite was loaded
+   */
+  bool init(ASGE::Renderer* renderer,
+            const std::string& texture_file_name,
+            size_t capacity);
+
+  /**
+   *  Fires a projectile.
+   *  @return the projectile's slot, or -1 if the pool is exhausted
+   */
+  int acquire(float pos_x, float pos_y, float vel_x, float vel_y) noexcept;
+
+  /**
+   *  Returns a live projectile to the pool. The last live projectile
+   *  takes its place in the active list, so when releasing during a
+   *  walk of live() walk it backwards.
+   *  @param [in] slot The projectile to release
+   */
+  void release(std::uint32_t slot) noexcept;
+
+  /**
+   *  Releases every live projectile.
+   */
+  void clear() noexcept;
+
+  /**
+   *  Moves part of the live list. Ranges that do not overlap can be
+   *  advanced on different threads.
+   *  @param [in] dt The tick length, in seconds
+   *  @param [in] first The first index into the live list
+   *  @param [in] last One past the last index into the live list
+   */
+  void advance(float dt, size_t first, size_t last) noexcept;
+
+  /**
+   *  Releases every live projectile outside the bounds.
+   *  @param [in] bounds The area projectiles stay live in
+   */
+  void cull(const Box& bounds) noexcept;
+
+  /**
+   *  Records every live position as the previous tick's.
+   */
+  void storePositions() noexcept;
+
+  /**
+   *  Adds every live projectile to a frame packet, interpolated between
+   *  the previous and current tick.
+   *  @param [in] alpha How far the frame is towards the current tick
+   *  @param [in] sprite_id The projectiles' sprite in the FrameRenderer
+   *  @param [in] z The depth the projectiles are drawn at
+   *  @param [out] packet The frame the draws are added to
+   */
+  void writeSprites(float alpha,
+                    std::uint16_t sprite_id,
+                    std::int16_t z,
+                    FramePacket& packet) const;
+
+  Box box(std::uint32_t slot) const noexcept;
+
+  /**
+   *  The live projectiles, in no particular order.
+   *  @return the slots of the live projectiles
+   */
+  const std::vector<std::uint32_t>& live() const noexcept;
+
+  /**
+   *  Saves the live projectiles, along with the order of the active and
+   *  free lists so that shots fired after a restore take the same slots.
+   *  @param [in] out The snapshot written to
+   */
+  void writeState(SnapshotWriter& out) const;
+
+  /**
+   *  Restores what writeState saved.
+   *  @param [in] in The snapshot read from
+   *  @return false if the snapshot is of another pool, or malformed
+   */
+  bool readState(SnapshotReader& in);
+
+  size_t capacity() const noexcept;
+  float width() const noexcept;
+  float height() const noexcept;
+
+ private:
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> prev_x;
+  std::vector<float> prev_y;
+  std::vector<float> vx;
+  std::vector<float> vy;
+
+  std::vector<std::uint32_t> free_slots;
+  std::vector<std::uint32_t> active;
+  std::vector<std::uint32_t> active_index; /**< Slot's place in active. */
+
+  SpriteComponent sprite;
+  float projectile_width = 0;
+  float projectile_height = 0;
+};
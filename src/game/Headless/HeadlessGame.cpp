@@ -0,0 +1,99 @@
+#include "HeadlessGame.h"
+#include "NullRenderer.h"
+#include <Engine/InputEvents.h>
+
+/**
+ *   @brief   Initialises the null subsystems.
+ *   @details No window is created. The file system is still mounted
+ *            so that the game can read its data folder as usual.
+ *   @return  True if the renderer and input were created.
+ */
+bool HeadlessGame::initAPI(ASGE::Renderer::WindowMode mode)
+{
+  renderer.reset(new NullRenderer());
+  if (!renderer->init(game_width, game_height, mode))
+  {
+    return false;
+  }
+
+  inputs = renderer->inputPtr();
+  if (!inputs->init(renderer.get()))
+  {
+    return false;
+  }
+
+  initFileIO();
+  return true;
+}
+
+bool HeadlessGame::exitAPI() noexcept
+{
+  return true;
+}
+
+void HeadlessGame::beginFrame()
+{
+  renderer->preRender();
+}
+
+/**
+ *   @brief   Ends a frame.
+ *   @details Each frame is timed from the end of the one before, so
+ *            the sample covers the update and render in between.
+ *   @return  void
+ */
+void HeadlessGame::endFrame()
+{
+  renderer->postRender();
+
+  const auto now = std::chrono::steady_clock::now();
+  if (frames_run == 0)
+  {
+    first_frame = now;
+  }
+  else if (record_frame_times)
+  {
+    frame_times.push_back(
+      std::chrono::duration<double>(now - last_frame).count());
+  }
+  last_frame = now;
+
+  if (++frames_run == frame_limit)
+  {
+    signalExit();
+  }
+}
+
+void HeadlessGame::frameLimit(unsigned long long frames) noexcept
+{
+  frame_limit = frames;
+}
+
+void HeadlessGame::sendKey(int key, int action)
+{
+  auto event = std::make_shared<ASGE::KeyEvent>();
+  event->key = key;
+  event->action = action;
+  inputs->sendEvent(ASGE::E_KEY, event);
+}
+
+void HeadlessGame::recordFrameTimes(size_t expected_frames)
+{
+  record_frame_times = true;
+  frame_times.reserve(expected_frames);
+}
+
+const std::vector<double>& HeadlessGame::frameTimes() const noexcept
+{
+  return frame_times;
+}
+
+unsigned long long HeadlessGame::framesRun() const noexcept
+{
+  return frames_run;
+}
+
+double HeadlessGame::secondsRun() const noexcept
+{
+  return std::chrono::duration<double>(last_frame - first_frame).count();
+}
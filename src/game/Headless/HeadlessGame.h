@@ -0,0 +1,63 @@
+#pragma once
+#include <Engine/Game.h>
+#include <chrono>
+#include <vector>
+
+/**
+ *  A windowless implementation of the Game engine.
+ *  Stands in for ASGE::OGLGame when the game is built with HEADLESS
+ *  defined. The renderer and input are null implementations, so the
+ *  game loop runs as fast as the CPU allows with no vsync, making it
+ *  suitable for soak tests and benchmarks on machines without a GPU.
+ *  @see NullRenderer
+ */
+class HeadlessGame : public ASGE::Game
+{
+ public:
+  ~HeadlessGame() override = default;
+
+  bool initAPI(ASGE::Renderer::WindowMode mode =
+                 ASGE::Renderer::WindowMode::WINDOWED) final;
+  bool exitAPI() noexcept final;
+  void beginFrame() final;
+  void endFrame() final;
+
+  /**
+   *  Limits the number of frames the game loop will run for.
+   *  Once reached the game signals its exit. Zero runs forever.
+   *  @param [in] frames The number of frames to simulate
+   */
+  void frameLimit(unsigned long long frames) noexcept;
+
+  /**
+   *  Injects a key event as if it came from the keyboard.
+   *  @param [in] key The key, see ASGE::KEYS
+   *  @param [in] action Pressed, released or repeated
+   */
+  void sendKey(int key, int action);
+
+  /**
+   *  Times every frame from here on, ready for benchmarking. A frame
+   *  covers the update and the render, as the game may simulate while
+   *  it draws.
+   *  @param [in] expected_frames Samples to reserve room for up front
+   */
+  void recordFrameTimes(size_t expected_frames);
+
+  /**
+   *  How long each frame took. The first frame is not sampled.
+   *  @return the frame times, in seconds
+   */
+  const std::vector<double>& frameTimes() const noexcept;
+
+  unsigned long long framesRun() const noexcept;
+  double secondsRun() const noexcept;
+
+ private:
+  unsigned long long frame_limit = 0;
+  unsigned long long frames_run = 0;
+  std::chrono::steady_clock::time_point first_frame;
+  std::chrono::steady_clock::time_point last_frame;
+  std::vector<double> frame_times;
+  bool record_frame_times = false;
+};
@@ -0,0 +1,135 @@
+#include "NullRenderer.h"
+#include "NullSprite.h"
+
+bool NullInput::init(ASGE::Renderer* /*renderer*/)
+{
+  return true;
+}
+
+void NullInput::update() {}
+
+void NullInput::getCursorPos(double& xpos, double& ypos) const
+{
+  xpos = 0;
+  ypos = 0;
+}
+
+void NullInput::setCursorMode(ASGE::MOUSE::CursorMode /*mode*/) {}
+
+const ASGE::GamePadData NullInput::getGamePad(int idx) const
+{
+  return ASGE::GamePadData(idx, "", 0, nullptr, 0, nullptr);
+}
+
+NullRenderer::NullRenderer() :
+  ASGE::Renderer(ASGE::Renderer::RenderLib::INVALID)
+{
+}
+
+void NullRenderer::setClearColour(ASGE::Colour rgb)
+{
+  cls = rgb;
+}
+
+int NullRenderer::loadFont(const char* /*font*/, int /*pt*/)
+{
+  return 0;
+}
+
+int NullRenderer::loadFontFromMem(const char* /*name*/,
+                                  const unsigned char* /*data*/,
+                                  unsigned int /*size*/,
+                                  int /*pt*/)
+{
+  return 0;
+}
+
+bool NullRenderer::init(int /*w*/, int /*h*/, ASGE::Renderer::WindowMode mode)
+{
+  window_mode = mode;
+  return true;
+}
+
+bool NullRenderer::exit()
+{
+  // there is no window to close, the game decides when to stop
+  return false;
+}
+
+void NullRenderer::preRender()
+{
+  draw_calls = 0;
+}
+
+void NullRenderer::postRender() {}
+
+void NullRenderer::renderText(std::string /*str*/,
+                              int /*x*/,
+                              int /*y*/,
+                              float /*scale*/,
+                              const ASGE::Colour& /*colour*/,
+                              float /*z_order*/)
+{
+  ++draw_calls;
+}
+
+void NullRenderer::setDefaultTextColour(const ASGE::Colour& colour)
+{
+  default_text_colour = colour;
+}
+
+ASGE::SHADER_LIB::Shader* NullRenderer::findShader(int /*shader_handle*/)
+{
+  return nullptr;
+}
+
+const ASGE::Font& NullRenderer::getActiveFont() const
+{
+  return font;
+}
+
+void NullRenderer::setFont(int /*id*/) {}
+
+void NullRenderer::renderSprite(const ASGE::Sprite& /*sprite*/,
+                                float /*z_order*/)
+{
+  ++draw_calls;
+}
+
+void NullRenderer::setSpriteMode(ASGE::SpriteSortMode /*mode*/) {}
+
+void NullRenderer::setWindowedMode(ASGE::Renderer::WindowMode mode)
+{
+  window_mode = mode;
+}
+
+void NullRenderer::setWindowTitle(const char* /*str*/) {}
+
+void NullRenderer::swapBuffers() {}
+
+std::unique_ptr<ASGE::Input> NullRenderer::inputPtr()
+{
+  return std::unique_ptr<ASGE::Input>(new NullInput());
+}
+
+std::unique_ptr<ASGE::Sprite> NullRenderer::createUniqueSprite()
+{
+  return std::unique_ptr<ASGE::Sprite>(new NullSprite());
+}
+
+ASGE::Sprite* NullRenderer::createRawSprite()
+{
+  return new NullSprite();
+}
+
+int NullRenderer::initPixelShader(std::string /*shader*/)
+{
+  return -1;
+}
+
+void NullRenderer::setActiveShader(ASGE::SHADER_LIB::Shader* /*shader*/) {}
+
+unsigned int NullRenderer::drawCalls() const noexcept
+{
+  return draw_calls;
+}
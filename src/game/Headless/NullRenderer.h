@@ -0,0 +1,79 @@
+#pragma once
+#include <Engine/Font.h>
+#include <Engine/Input.h>
+#include <Engine/Renderer.h>
+#include <memory>
+#include <string>
+
+/**
+ *  An input system with no devices attached.
+ *  Events can still be pushed through sendEvent, which is how the
+ *  headless build drives the game without a keyboard.
+ */
+class NullInput : public ASGE::Input
+{
+ public:
+  NullInput() = default;
+  ~NullInput() override = default;
+
+  bool init(ASGE::Renderer* renderer) override;
+  void update() override;
+  void getCursorPos(double& xpos, double& ypos) const override;
+  void setCursorMode(ASGE::MOUSE::CursorMode mode) override;
+  const ASGE::GamePadData getGamePad(int idx) const override;
+};
+
+/**
+ *  A renderer that draws nothing.
+ *  Used by the headless build so that the game can be simulated on
+ *  machines without a window or GL context. Sprites it creates are
+ *  NullSprites, and draw calls are counted rather than submitted.
+ *  @see NullSprite
+ */
+class NullRenderer : public ASGE::Renderer
+{
+ public:
+  NullRenderer();
+  ~NullRenderer() override = default;
+
+  void setClearColour(ASGE::Colour rgb) override;
+  int loadFont(const char* font, int pt) override;
+  int loadFontFromMem(const char* name,
+                      const unsigned char* data,
+                      unsigned int size,
+                      int pt) override;
+  bool init(int w, int h, ASGE::Renderer::WindowMode mode) override;
+  bool exit() override;
+  void preRender() override;
+  void postRender() override;
+  void renderText(std::string str,
+                  int x,
+                  int y,
+                  float scale,
+                  const ASGE::Colour& colour,
+                  float z_order) override;
+  void setDefaultTextColour(const ASGE::Colour& colour) override;
+  ASGE::SHADER_LIB::Shader* findShader(int shader_handle) override;
+  const ASGE::Font& getActiveFont() const override;
+  void setFont(int id) override;
+  void renderSprite(const ASGE::Sprite& sprite, float z_order) override;
+  void setSpriteMode(ASGE::SpriteSortMode mode) override;
+  void setWindowedMode(ASGE::Renderer::WindowMode mode) override;
+  void setWindowTitle(const char* str) override;
+  void swapBuffers() override;
+  std::unique_ptr<ASGE::Input> inputPtr() override;
+  std::unique_ptr<ASGE::Sprite> createUniqueSprite() override;
+  ASGE::Sprite* createRawSprite() override;
+  int initPixelShader(std::string shader) override;
+  void setActiveShader(ASGE::SHADER_LIB::Shader* shader) override;
+
+  /**
+   *  Number of sprites and strings submitted since the last preRender.
+   *  @return the draw calls made during the current frame
+   */
+  unsigned int drawCalls() const noexcept;
+
+ private:
+  ASGE::Font font;
+  unsigned int draw_calls = 0;
+};
@@ -0,0 +1,78 @@
+#include "NullSprite.h"
+#include <Engine/FileIO.h>
+
+namespace
+{
+  constexpr size_t PNG_HEADER_LENGTH = 24;
+  constexpr unsigned char PNG_SIGNATURE[8] = {
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+  };
+
+  unsigned int readBigEndian(const unsigned char* bytes)
+  {
+    return (static_cast<unsigned int>(bytes[0]) << 24U) |
+           (static_cast<unsigned int>(bytes[1]) << 16U) |
+           (static_cast<unsigned int>(bytes[2]) << 8U) |
+           static_cast<unsigned int>(bytes[3]);
+  }
+}
+
+NullTexture::NullTexture(unsigned int width, unsigned int height) :
+  ASGE::Texture2D(static_cast<int>(width), static_cast<int>(height))
+{
+  format = RGBA;
+}
+
+void NullTexture::setData(void* /*data*/) {}
+
+void* NullTexture::getData()
+{
+  return nullptr;
+}
+
+/**
+ *   @brief   Sizes the sprite using the image header.
+ *   @details ASGE's files can only be read whole, but only the PNG
+ *            signature and the IHDR chunk are inspected, which is all the
+ *            simulation needs to know about a texture.
+ *   @return  True if the image dimensions could be read.
+ */
+bool NullSprite::loadTexture(const std::string& file_name)
+{
+  ASGE::FILEIO::File file;
+  if (!file.open(file_name))
+  {
+    return false;
+  }
+
+  auto buffer = file.read();
+  file.close();
+
+  if (buffer.length < PNG_HEADER_LENGTH)
+  {
+    return false;
+  }
+
+  const unsigned char* bytes = buffer.as_unsigned_char();
+  for (size_t i = 0; i < sizeof(PNG_SIGNATURE); ++i)
+  {
+    if (bytes[i] != PNG_SIGNATURE[i])
+    {
+      return false;
+    }
+  }
+
+  // the IHDR chunk always follows the signature: width then height
+  texture = NullTexture(readBigEndian(bytes + 16), readBigEndian(bytes + 20));
+
+  dims[0] = static_cast<float>(texture.getWidth());
+  dims[1] = static_cast<float>(texture.getHeight());
+  src_rect[2] = dims[0];
+  src_rect[3] = dims[1];
+  return true;
+}
+
+const ASGE::Texture2D* NullSprite::getTexture() const
+{
+  return &texture;
+}
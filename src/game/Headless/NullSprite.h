@@ -0,0 +1,45 @@
+#pragma once
+#include <Engine/Sprite.h>
+#include <Engine/Texture.h>
+#include <string>
+
+/**
+ *  A texture that never reaches the GPU.
+ *  Only the dimensions of the image are kept so that sprites
+ *  created from it can still be sized and collided with.
+ */
+class NullTexture : public ASGE::Texture2D
+{
+ public:
+  NullTexture() : ASGE::Texture2D(0, 0) {}
+  NullTexture(unsigned int width, unsigned int height);
+  ~NullTexture() override = default;
+
+  void setData(void* data) override;
+  void* getData() override;
+};
+
+/**
+ *  A sprite used by the headless build.
+ *  Loading a texture only inspects the image header to find its
+ *  dimensions, nothing is decoded or uploaded. Everything else
+ *  behaves exactly like a regular ASGE sprite.
+ *  @see NullRenderer
+ */
+class NullSprite : public ASGE::Sprite
+{
+ public:
+  NullSprite() = default;
+  ~NullSprite() override = default;
+
+  /**
+   *  Reads the dimensions of the image and sizes the sprite to match.
+   *  @param [in] file_name The file path to the the texture to load
+   *  @return true if the file exists and is a readable PNG
+   */
+  bool loadTexture(const std::string& file_name) override;
+  const ASGE::Texture2D* getTexture() const override;
+
+ private:
+  NullTexture texture;
+};
@@ -0,0 +1,35 @@
+#include "InputQueue.h"
+
+constexpr size_t InputQueue::CAPACITY;
+
+bool InputQueue::push(const InputCommand& command) noexcept
+{
+  const std::uint64_t next = tail.load(std::memory_order_relaxed);
+  if (next - head.load(std::memory_order_acquire) == CAPACITY)
+  {
+    drops.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  commands[next & (CAPACITY - 1)] = command;
+  tail.store(next + 1, std::memory_order_release);
+  return true;
+}
+
+bool InputQueue::pop(InputCommand& command) noexcept
+{
+  const std::uint64_t next = head.load(std::memory_order_relaxed);
+  if (next == tail.load(std::memory_order_acquire))
+  {
+    return false;
+  }
+
+  command = commands[next & (CAPACITY - 1)];
+  head.store(next + 1, std::memory_order_release);
+  return true;
+}
+
+unsigned long long InputQueue::dropped() const noexcept
+{
+  return drops.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ *  A key event waiting to be applied to the game.
+ */
+struct InputCommand
+{
+  int key = -1;
+  int action = -1;
+  int mods = -1;
+  std::int64_t time = 0; /**< When it was queued, on the profiler clock. */
+};
+
+/**
+ *  Hands key events from the input callbacks to the simulation without
+ *  either waiting on the other.
+ *  A fixed ring with one producer and one consumer: the producer only
+ *  writes the tail and the consumer only writes the head, so each side
+ *  publishes its progress with a single release store. ASGE delivers
+ *  callbacks one at a time, even when it runs them on their own threads,
+ *  so the callbacks together act as the one producer. Once full, further
+ *  commands are dropped rather than blocking the input thread.
+ */
+class InputQueue
+{
+ public:
+  static constexpr size_t CAPACITY = 256;
+
+  InputQueue() = default;
+  ~InputQueue() = default;
+
+  InputQueue(const InputQueue&) = delete;
+  InputQueue& operator=(const InputQueue&) = delete;
+
+  /**
+   *  Queues a command. Producer only.
+   *  @param [in] command The command to queue
+   *  @return false if the queue was full and the command dropped
+   */
+  bool push(const InputCommand& command) noexcept;
+
+  /**
+   *  Takes the oldest command. Consumer only.
+   *  @param [out] command The command taken
+   *  @return false if the queue was empty
+   */
+  bool pop(InputCommand& command) noexcept;
+
+  /**
+   *  @return the number of commands dropped because the queue was full
+   */
+  unsigned long long dropped() const noexcept;
+
+ private:
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0,
+                "the capacity must be a power of two");
+
+  std::atomic<std::uint64_t> tail{ 0 };
+  std::atomic<unsigned long long> drops{ 0 };
+  std::array<InputCommand, CAPACITY> commands;
+  std::atomic<std::uint64_t> head{ 0 };
+};
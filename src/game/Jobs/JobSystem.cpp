@@ -0,0 +1,381 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+struct JobSystem::Job
+{
+  JobFunction function = nullptr;
+  void* context = nullptr;
+  size_t begin = 0;
+  size_t end = 0;
+  size_t grain = 0;
+  Job* parent = nullptr;
+
+  // the job itself plus any chunks it has split into
+  std::atomic<int> unfinished{ 0 };
+  // dependencies still running, plus one until submitted
+  std::atomic<int> dependencies{ 0 };
+  std::atomic<size_t> continuation_count{ 0 };
+  Job* continuations[MAX_CONTINUATIONS] = {};
+};
+
+/**
+ *  One thread's jobs. The owner pushes and pops at the back, thieves
+ *  take from the front, so the owner works on what it made most
+ *  recently while the oldest, usually largest, jobs are stolen.
+ */
+struct JobSystem::Queue
+{
+  std::mutex mutex;
+  std::vector<Job*> ring;
+  size_t head = 0;
+  size_t count = 0;
+
+  void push(Job* job)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ring[(head + count) % ring.size()] = job;
+    ++count;
+  }
+
+  Job* popBack()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0)
+    {
+      return nullptr;
+    }
+    --count;
+    return ring[(head + count) % ring.size()];
+  }
+
+  Job* popFront()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0)
+    {
+      return nullptr;
+    }
+    Job* job = ring[head];
+    head = (head + 1) % ring.size();
+    --count;
+    return job;
+  }
+};
+
+constexpr size_t JobSystem::MAX_CONTINUATIONS;
+
+namespace
+{
+  // the system and queue of the worker running on this thread
+  thread_local const JobSystem* worker_of = nullptr;
+  thread_local size_t worker_queue = 0;
+}
+
+JobSystem::JobSystem(size_t job_capacity) :
+  capacity(job_capacity),
+  jobs(new Job[job_capacity]),
+  queues(new Queue[1])
+{
+  queues[0].ring.resize(capacity);
+}
+
+JobSystem::~JobSystem()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+}
+
+/**
+ *   @brief   Starts the worker pool.
+ *   @details Each worker gets its own queue, the calling thread and
+ *            any other thread that is not a worker share the first.
+ *   @return  void
+ */
+void JobSystem::start(size_t worker_count)
+{
+  if (!workers.empty())
+  {
+    return;
+  }
+
+  if (worker_count == 0)
+  {
+    const size_t cores = std::thread::hardware_concurrency();
+    worker_count = cores > 1 ? cores - 1 : 0;
+  }
+
+  queue_count = worker_count + 1;
+  queues.reset(new Queue[queue_count]);
+  for (size_t i = 0; i < queue_count; ++i)
+  {
+    queues[i].ring.resize(capacity);
+  }
+
+  workers.reserve(worker_count);
+  for (size_t i = 1; i <= worker_count; ++i)
+  {
+    workers.emplace_back(&JobSystem::work, this, i);
+  }
+}
+
+size_t JobSystem::threads() const noexcept
+{
+  return workers.size() + 1;
+}
+
+JobSystem::Job* JobSystem::create(JobFunction function,
+                                  void* context,
+                                  size_t begin,
+                                  size_t end)
+{
+  return allocate(function, context, begin, end, 0, nullptr);
+}
+
+JobSystem::Job* JobSystem::createFor(JobFunction function,
+                                     void* context,
+                                     size_t count,
+                                     size_t grain)
+{
+  return allocate(
+    function, context, 0, count, std::max<size_t>(grain, 1), nullptr);
+}
+
+bool JobSystem::dependsOn(Job* job, Job* dependency) noexcept
+{
+  const size_t slot = dependency->continuation_count++;
+  if (slot >= MAX_CONTINUATIONS)
+  {
+    --dependency->continuation_count;
+    return false;
+  }
+
+  ++job->dependencies;
+  dependency->continuations[slot] = job;
+  return true;
+}
+
+void JobSystem::submit(Job* job)
+{
+  ++outstanding;
+  release(job);
+}
+
+void JobSystem::release(Job* job)
+{
+  if (--job->dependencies == 0)
+  {
+    push(job);
+  }
+}
+
+/**
+ *   @brief   Waits for a job to finish.
+ *   @details Rather than block, the waiting thread runs whatever jobs
+ *            it can find, which is also how jobs get run at all when
+ *            there are no workers.
+ *   @return  void
+ */
+void JobSystem::wait(const Job* job)
+{
+  const size_t queue = queueIndex();
+  while (job->unfinished > 0)
+  {
+    Job* next = take(queue);
+    if (next != nullptr)
+    {
+      execute(next);
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void JobSystem::reset()
+{
+  const size_t queue = queueIndex();
+  while (outstanding > 0)
+  {
+    Job* next = take(queue);
+    if (next != nullptr)
+    {
+      execute(next);
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  next_job = 0;
+}
+
+JobSystem::Job* JobSystem::allocate(JobFunction function,
+                                    void* context,
+                                    size_t begin,
+                                    size_t end,
+                                    size_t grain,
+                                    Job* parent) noexcept
+{
+  const size_t index = next_job++;
+  if (index >= capacity)
+  {
+    return nullptr;
+  }
+
+  Job* job = &jobs[index];
+  job->function = function;
+  job->context = context;
+  job->begin = begin;
+  job->end = end;
+  job->grain = grain;
+  job->parent = parent;
+  job->unfinished = 1;
+  job->dependencies = 1;
+  job->continuation_count = 0;
+  return job;
+}
+
+/**
+ *   @brief   Queues a job that is ready to run.
+ *   @details Sleeping workers are only woken, which takes a lock, when
+ *            there are any. A worker counts itself as sleeping before
+ *            it checks for work, so one of the two always sees the
+ *            other.
+ *   @return  void
+ */
+void JobSystem::push(Job* job)
+{
+  queues[queueIndex()].push(job);
+  ++queued;
+
+  if (sleeping > 0)
+  {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_one();
+  }
+}
+
+/**
+ *   @brief   Finds the next job for a thread.
+ *   @details The thread's own queue comes first, newest job first.
+ *            Failing that the other queues are stolen from, oldest job
+ *            first, starting from the next queue along so thieves
+ *            spread out over their victims.
+ *   @return  The job, or nullptr if every queue is empty.
+ */
+JobSystem::Job* JobSystem::take(size_t queue)
+{
+  Job* job = queues[queue].popBack();
+  for (size_t i = 1; job == nullptr && i < queue_count; ++i)
+  {
+    job = queues[(queue + i) % queue_count].popFront();
+  }
+
+  if (job != nullptr)
+  {
+    --queued;
+  }
+  return job;
+}
+
+/**
+ *   @brief   Runs a job.
+ *   @details A job over a range larger than its grain queues a chunk
+ *            job for each piece of the range instead, which idle
+ *            threads steal. If the job storage runs out the remaining
+ *            chunks run here.
+ *   @return  void
+ */
+void JobSystem::execute(Job* job)
+{
+  if (job->grain == 0)
+  {
+    job->function(job->context, job->begin, job->end);
+    finish(job);
+    return;
+  }
+
+  for (size_t begin = job->begin; begin < job->end; begin += job->grain)
+  {
+    const size_t end = std::min(begin + job->grain, job->end);
+
+    ++job->unfinished;
+    Job* chunk = allocate(job->function, job->context, begin, end, 0, job);
+    if (chunk == nullptr)
+    {
+      --job->unfinished;
+      job->function(job->context, begin, end);
+      continue;
+    }
+
+    chunk->dependencies = 0;
+    ++outstanding;
+    push(chunk);
+  }
+
+  finish(job);
+}
+
+/**
+ *   @brief   Marks one part of a job as done.
+ *   @details Once the job and all of its chunks are done, the jobs
+ *            waiting on it are released and its parent told.
+ *   @return  void
+ */
+void JobSystem::finish(Job* job)
+{
+  if (--job->unfinished == 0)
+  {
+    const size_t continuations =
+      std::min(job->continuation_count.load(), MAX_CONTINUATIONS);
+    for (size_t i = 0; i < continuations; ++i)
+    {
+      release(job->continuations[i]);
+    }
+
+    if (job->parent != nullptr)
+    {
+      finish(job->parent);
+    }
+
+    --outstanding;
+  }
+}
+
+size_t JobSystem::queueIndex() const noexcept
+{
+  return worker_of == this ? worker_queue : 0;
+}
+
+void JobSystem::work(size_t queue)
+{
+  worker_of = this;
+  worker_queue = queue;
+
+  while (!stopping)
+  {
+    Job* job = take(queue);
+    if (job != nullptr)
+    {
+      execute(job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    ++sleeping;
+    wake.wait(lock, [this] { return stopping || queued > 0; });
+    --sleeping;
+  }
+}
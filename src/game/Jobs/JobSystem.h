@@ -0,0 +1,172 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ *  Work-stealing job scheduler over a fixed pool of worker threads.
+ *  Every thread has its own queue. New jobs go on the back of the
+ *  queue of the thread creating them and are taken from there first,
+ *  so work stays on the core that made it; an idle thread steals from
+ *  the front of the others' queues. A thread waiting on a job runs
+ *  other jobs until it finishes, so jobs may wait on jobs they create.
+ *  Jobs come from storage allocated up front and recycled by reset, so
+ *  scheduling never touches the heap.
+ *
+ *  Before start is called, or with no workers, every job runs on the
+ *  thread that waits for it.
+ */
+class JobSystem
+{
+ public:
+  /**
+   *  Runs the job over part of its range.
+   *  @param [in] context The context given when the job was created
+   *  @param [in] begin The first index to process
+   *  @param [in] end One past the last index to process
+   */
+  using JobFunction = void (*)(void* context, size_t begin, size_t end);
+
+  struct Job;
+
+  /**
+   *  The most jobs that can depend on a single job.
+   */
+  static constexpr size_t MAX_CONTINUATIONS = 16;
+
+  /**
+   *  @param [in] job_capacity The most jobs in use between resets
+   */
+  explicit JobSystem(size_t job_capacity = 4096);
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  /**
+   *  Starts the worker threads. Does nothing if already started.
+   *  @param [in] worker_count Workers besides the calling thread, zero
+   *              for one fewer than the number of cores
+   */
+  void start(size_t worker_count = 0);
+
+  /**
+   *  @return the number of threads that run jobs, the caller included
+   */
+  size_t threads() const noexcept;
+
+  /**
+   *  Creates a job over a range, run in one piece.
+   *  @return the job, or nullptr if the job storage is exhausted
+   */
+  Job* create(JobFunction function, void* context, size_t begin, size_t end);
+
+  /**
+   *  Creates a job over the range [0, count) that splits into chunks of
+   *  at most grain indices when it runs, the chunks spread over the
+   *  workers. It finishes once every chunk has.
+   *  @return the job, or nullptr if the job storage is exhausted
+   */
+  Job* createFor(JobFunction function,
+                 void* context,
+                 size_t count,
+                 size_t grain);
+
+  /**
+   *  Holds a job back until another has finished. Every dependency of
+   *  a job must be declared before either job is submitted.
+   *  @param [in] job The job to hold back
+   *  @param [in] dependency The job that must finish first
+   *  @return false if the dependency already has MAX_CONTINUATIONS
+   */
+  bool dependsOn(Job* job, Job* dependency) noexcept;
+
+  /**
+   *  Queues a job, to run once its dependencies have finished.
+   *  @param [in] job The job to run
+   */
+  void submit(Job* job);
+
+  /**
+   *  Runs jobs until the given one has finished.
+   *  @param [in] job The job to wait for
+   */
+  void wait(const Job* job);
+
+  /**
+   *  Recycles the storage of every job. Waits for any submitted jobs
+   *  still running; jobs that were created but never submitted are
+   *  simply dropped.
+   */
+  void reset();
+
+  /**
+   *  Runs a function over [0, count) in chunks of at most grain
+   *  indices and waits for it. The chunks always start on a multiple
+   *  of grain, so begin / grain numbers them. Ranges no bigger than
+   *  one chunk run straight away on the calling thread.
+   *  @param [in] count The number of indices
+   *  @param [in] grain The most indices handed to one call
+   *  @param [in] body Called as body(begin, end) for each chunk
+   */
+  template <typename Body>
+  void parallelFor(size_t count, size_t grain, Body& body)
+  {
+    Job* job = count > grain && !workers.empty()
+                 ? createFor(&invoke<Body>, &body, count, grain)
+                 : nullptr;
+    if (job != nullptr)
+    {
+      submit(job);
+      wait(job);
+      return;
+    }
+
+    for (size_t begin = 0; begin < count; begin += grain)
+    {
+      body(begin, begin + grain < count ? begin + grain : count);
+    }
+  }
+
+ private:
+  template <typename Body>
+  static void invoke(void* context, size_t begin, size_t end)
+  {
+    (*static_cast<Body*>(context))(begin, end);
+  }
+
+  struct Queue;
+
+  Job* allocate(JobFunction function,
+                void* context,
+                size_t begin,
+                size_t end,
+                size_t grain,
+                Job* parent) noexcept;
+  void release(Job* job);
+  void push(Job* job);
+  Job* take(size_t queue);
+  void execute(Job* job);
+  void finish(Job* job);
+  size_t queueIndex() const noexcept;
+  void work(size_t queue);
+
+  size_t capacity;
+  std::unique_ptr<Job[]> jobs;
+  std::atomic<size_t> next_job{ 0 };
+  std::atomic<size_t> outstanding{ 0 };
+
+  std::unique_ptr<Queue[]> queues;
+  size_t queue_count = 1;
+  std::vector<std::thread> workers;
+
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  std::atomic<size_t> queued{ 0 };
+  std::atomic<size_t> sleeping{ 0 };
+  std::atomic<bool> stopping{ false };
+};
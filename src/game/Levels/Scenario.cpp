@@ -0,0 +1,46 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // the ticks the aliens take to fill their shot pool from empty
+  const size_t SHOT_FILL_TICKS = 30;
+}
+
+/**
+ *   @brief   Builds a stress scenario
+ *   @details The grid has about as many columns per row as the area is
+ *            wide per unit high, so the spacing shrinks evenly in both
+ *            directions as the formation grows. Spacing never grows
+ *            past the game's own, so small formations look as usual.
+ *   @return  The scenario.
+ */
+Scenario
+stressScenario(size_t aliens, size_t shots, float width, float height)
+{
+  Scenario scenario;
+  scenario.aliens = aliens;
+
+  const double aspect = static_cast<double>(width / height);
+  auto columns = static_cast<size_t>(
+    std::ceil(std::sqrt(static_cast<double>(aliens) * aspect)));
+  columns = std::max<size_t>(1, std::min(columns, aliens));
+  const size_t rows = std::max<size_t>(1, (aliens + columns - 1) / columns);
+
+  scenario.aliens_per_row = columns;
+  scenario.alien_spacing =
+    std::min(scenario.alien_spacing, width / static_cast<float>(columns));
+  scenario.row_spacing =
+    std::min(scenario.row_spacing, height / static_cast<float>(rows));
+
+  scenario.player_shots = shots;
+  scenario.alien_shots = shots;
+  scenario.fire_interval = 1;
+  scenario.volley = std::max<size_t>(
+    1, (shots + SHOT_FILL_TICKS - 1) / SHOT_FILL_TICKS);
+
+  scenario.autofire = 1;
+  scenario.endless = true;
+  return scenario;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ *  Where a barrier is placed, by its top left corner.
+ */
+struct BarrierPlacement
+{
+  float x = 0;
+  float y = 0;
+};
+
+/**
+ *  What a level is made of: the size, layout and movement of the
+ *  formation, the barriers, and how many shots can be in flight and how
+ *  often they are fired. The defaults are the game as it is played;
+ *  waves replace the level's part of it, and stress scenarios scale it
+ *  up to find what each entity costs.
+ *  @see WaveCache
+ *  @see stressScenario
+ */
+struct Scenario
+{
+  size_t aliens = 50;
+  size_t aliens_per_row = 10;
+  float alien_spacing = 40.0F;
+  float row_spacing = 20.0F;
+  float left = 100.0F; /**< Where the formation starts. */
+  float top = 20.0F;
+
+  int movement = -1;      /**< As numbered on the menu, -1 for its choice. */
+  float speed = 200.0F;   /**< Across the screen, in pixels a second. */
+  float gravity = 245.0F; /**< Fall rate gained a second, in gravity mode. */
+
+  size_t barriers = 4; /**< Spread evenly across the screen, unless placed. */
+  std::vector<BarrierPlacement> barrier_layout;
+
+  size_t player_shots = 256; /**< Player lasers in flight at once. */
+  size_t alien_shots = 256;  /**< Alien lasers in flight at once. */
+  unsigned int fire_interval = 30; /**< Ticks between alien volleys. */
+  size_t volley = 1;               /**< Aliens firing in each volley. */
+
+  size_t autofire = 0; /**< Lasers the defender fires each tick unasked. */
+  bool endless = false; /**< Whether the game carries on once it is lost. */
+};
+
+/**
+ *  Builds a scenario of any size to measure the game under load.
+ *  The formation is laid out as a grid with the area's aspect ratio,
+ *  packed as tightly as it needs to be to fit. The aliens fire volleys
+ *  every tick until the shots in flight reach the requested count, and
+ *  the defender fires every tick. Losing does not end a stress
+ *  scenario, so every tick measured carries the same load.
+ *  @param [in] aliens The number of aliens
+ *  @param [in] shots The shots each side may have in flight
+ *  @param [in] width The width the formation may cover
+ *  @param [in] height The height the formation may cover
+ *  @return the scenario
+ */
+Scenario
+stressScenario(size_t aliens, size_t shots, float width, float height);
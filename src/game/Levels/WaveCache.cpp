@@ -0,0 +1,349 @@
+#include "WaveCache.h"
+#include <Engine/DebugPrinter.h>
+#include <Engine/FileIO.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+  const char MAGIC[4] = { 'S', 'I', 'W', 'V' };
+  const std::uint32_t VERSION = 1;
+
+  // a wave with no placements spreads its barriers evenly
+  const std::uint32_t SPREAD_EVENLY = 0xFFFFFFFFU;
+
+  const char* const MOVEMENT_NAMES[] = { "linear",
+                                         "gravity",
+                                         "quadratic",
+                                         "sine" };
+
+  /**
+   *  FNV-1a, enough to tell whether the json has changed since the
+   *  cache was compiled.
+   */
+  std::uint64_t hashBytes(const char* bytes, size_t length) noexcept
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+      hash ^= static_cast<std::uint8_t>(bytes[i]);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  float number(const nlohmann::json& object, const char* key, float fallback)
+  {
+    auto value = object.find(key);
+    return value != object.end() && value->is_number() ? value->get<float>()
+                                                       : fallback;
+  }
+
+  std::uint32_t
+  count(const nlohmann::json& object, const char* key, size_t fallback)
+  {
+    auto value = object.find(key);
+    if (value != object.end() && value->is_number_unsigned())
+    {
+      return value->get<std::uint32_t>();
+    }
+    return static_cast<std::uint32_t>(fallback);
+  }
+
+  std::int32_t movement(const nlohmann::json& wave)
+  {
+    auto value = wave.find("movement");
+    if (value == wave.end() || !value->is_string())
+    {
+      return -1;
+    }
+
+    for (std::int32_t mode = 0; mode < 4; ++mode)
+    {
+      if (value->get<std::string>() == MOVEMENT_NAMES[mode])
+      {
+        return mode;
+      }
+    }
+    return -1;
+  }
+
+  template <typename T>
+  void append(std::vector<std::uint8_t>& blob, const T& value)
+  {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    blob.insert(blob.end(), bytes, bytes + sizeof(T));
+  }
+}
+
+/**
+ *   @brief   Loads the waves
+ *   @details The json is always read, as hashing it is how a stale cache
+ *            is spotted, but it is only parsed when the cache is
+ *            missing or stale. A new cache is written to one side and
+ *            then moved over the old one, so a game starting at the same
+ *            time never maps half of it.
+ *   @return  True if there are waves to play.
+ */
+bool WaveCache::load(const std::string& source_file,
+                     const std::string& cache_file)
+{
+  cache.close();
+  compiled.clear();
+  waves = nullptr;
+  barriers = nullptr;
+  wave_count = 0;
+  from_cache = false;
+
+  ASGE::FILEIO::File file;
+  if (!file.open(source_file))
+  {
+    return false;
+  }
+
+  auto buffer = file.read();
+  file.close();
+
+  const std::uint64_t hash = hashBytes(buffer.as_char(), buffer.length);
+  if (cache.open(cache_file) && use(cache.data(), cache.size(), hash))
+  {
+    from_cache = true;
+    return wave_count > 0;
+  }
+  cache.close();
+
+  if (!compile(buffer.as_char(), buffer.length, hash, compiled))
+  {
+    ASGE::DebugPrinter{} << "invalid waves: " << source_file << std::endl;
+    return false;
+  }
+
+  const std::string partial = cache_file + ".tmp";
+  bool written = false;
+  {
+    std::ofstream out(partial, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(compiled.data()),
+              static_cast<std::streamsize>(compiled.size()));
+    written = out.good();
+  }
+
+  std::remove(cache_file.c_str());
+  if (written && std::rename(partial.c_str(), cache_file.c_str()) == 0 &&
+      cache.open(cache_file) && use(cache.data(), cache.size(), hash))
+  {
+    compiled.clear();
+    compiled.shrink_to_fit();
+    return wave_count > 0;
+  }
+
+  // the cache could not be written, so play from the compiled copy
+  cache.close();
+  std::remove(partial.c_str());
+  return use(compiled.data(), compiled.size(), hash) && wave_count > 0;
+}
+
+/**
+ *   @brief   Compiles the json into a blob
+ *   @details The blob is a header, every wave as a fixed size record,
+ *            then a table of the barriers the waves place. Anything a
+ *            wave leaves out keeps the game's default.
+ *   @return  True if the json held a list of waves.
+ */
+bool WaveCache::compile(const char* json,
+                        size_t length,
+                        std::uint64_t source_hash,
+                        std::vector<std::uint8_t>& blob)
+{
+  auto source = nlohmann::json::parse(json, json + length, nullptr, false);
+  if (source.is_discarded() || !source.is_object())
+  {
+    return false;
+  }
+
+  auto list = source.find("waves");
+  if (list == source.end() || !list->is_array())
+  {
+    return false;
+  }
+
+  const Scenario defaults;
+  std::vector<WaveRecord> records;
+  std::vector<BarrierRecord> placements;
+
+  for (const auto& wave : *list)
+  {
+    if (!wave.is_object())
+    {
+      return false;
+    }
+
+    WaveRecord record = {};
+    record.aliens = std::max(1U, count(wave, "aliens", defaults.aliens));
+    record.aliens_per_row =
+      std::max(1U, count(wave, "aliens_per_row", defaults.aliens_per_row));
+    record.alien_spacing =
+      number(wave, "alien_spacing", defaults.alien_spacing);
+    record.row_spacing = number(wave, "row_spacing", defaults.row_spacing);
+    record.left = number(wave, "left", defaults.left);
+    record.top = number(wave, "top", defaults.top);
+    record.movement = movement(wave);
+    record.speed = number(wave, "speed", defaults.speed);
+    record.gravity = number(wave, "gravity", defaults.gravity);
+    record.fire_interval =
+      std::max(1U, count(wave, "fire_interval", defaults.fire_interval));
+    record.volley = count(wave, "volley", defaults.volley);
+
+    // either a number of barriers spread evenly, or where to place each
+    record.first_barrier = SPREAD_EVENLY;
+    record.barrier_count = count(wave, "barriers", defaults.barriers);
+    auto layout = wave.find("barriers");
+    if (layout != wave.end() && layout->is_array())
+    {
+      record.first_barrier = static_cast<std::uint32_t>(placements.size());
+      record.barrier_count = static_cast<std::uint32_t>(layout->size());
+      for (const auto& barrier : *layout)
+      {
+        placements.push_back(
+          BarrierRecord{ number(barrier, "x", 0), number(barrier, "y", 0) });
+      }
+    }
+
+    records.push_back(record);
+  }
+
+  Header header = {};
+  std::copy(std::begin(MAGIC), std::end(MAGIC), header.magic);
+  header.version = VERSION;
+  header.source_hash = source_hash;
+  header.wave_count = static_cast<std::uint32_t>(records.size());
+  header.barrier_count = static_cast<std::uint32_t>(placements.size());
+
+  blob.clear();
+  blob.reserve(sizeof(Header) + records.size() * sizeof(WaveRecord) +
+               placements.size() * sizeof(BarrierRecord));
+  append(blob, header);
+  for (const auto& record : records)
+  {
+    append(blob, record);
+  }
+  for (const auto& placement : placements)
+  {
+    append(blob, placement);
+  }
+  return true;
+}
+
+/**
+ *   @brief   Plays the waves held in a blob
+ *   @details The records are used where they lie, so nothing is copied
+ *            or parsed. The blob is checked to be the one compiled from
+ *            the json, and that it is whole, first.
+ *   @return  True if the blob is current and whole.
+ */
+bool WaveCache::use(const std::uint8_t* blob,
+                    size_t length,
+                    std::uint64_t hash)
+{
+  if (blob == nullptr || length < sizeof(Header))
+  {
+    return false;
+  }
+
+  Header header = {};
+  std::memcpy(&header, blob, sizeof(Header));
+  if (!std::equal(std::begin(MAGIC), std::end(MAGIC), header.magic) ||
+      header.version != VERSION || header.source_hash != hash ||
+      length != sizeof(Header) + header.wave_count * sizeof(WaveRecord) +
+                  header.barrier_count * sizeof(BarrierRecord))
+  {
+    return false;
+  }
+
+  const auto* records =
+    reinterpret_cast<const WaveRecord*>(blob + sizeof(Header));
+  for (size_t i = 0; i < header.wave_count; ++i)
+  {
+    const WaveRecord& record = records[i];
+    const bool spread = record.first_barrier == SPREAD_EVENLY;
+    if (record.aliens == 0 || record.aliens_per_row == 0 ||
+        record.fire_interval == 0 ||
+        (!spread && (record.first_barrier > header.barrier_count ||
+                     record.barrier_count >
+                       header.barrier_count - record.first_barrier)))
+    {
+      return false;
+    }
+  }
+
+  waves = records;
+  barriers = reinterpret_cast<const BarrierRecord*>(
+    blob + sizeof(Header) + header.wave_count * sizeof(WaveRecord));
+  wave_count = header.wave_count;
+  return true;
+}
+
+void WaveCache::apply(size_t wave, Scenario& scenario) const
+{
+  const WaveRecord& record = waves[wave];
+  scenario.aliens = record.aliens;
+  scenario.aliens_per_row = record.aliens_per_row;
+  scenario.alien_spacing = record.alien_spacing;
+  scenario.row_spacing = record.row_spacing;
+  scenario.left = record.left;
+  scenario.top = record.top;
+  scenario.movement = record.movement;
+  scenario.speed = record.speed;
+  scenario.gravity = record.gravity;
+  scenario.fire_interval = record.fire_interval;
+  scenario.volley = record.volley;
+
+  scenario.barriers = record.barrier_count;
+  scenario.barrier_layout.clear();
+  if (record.first_barrier != SPREAD_EVENLY)
+  {
+    for (size_t i = 0; i < record.barrier_count; ++i)
+    {
+      const BarrierRecord& barrier = barriers[record.first_barrier + i];
+      scenario.barrier_layout.push_back(
+        BarrierPlacement{ barrier.x, barrier.y });
+    }
+  }
+}
+
+size_t WaveCache::size() const noexcept
+{
+  return wave_count;
+}
+
+bool WaveCache::empty() const noexcept
+{
+  return wave_count == 0;
+}
+
+bool WaveCache::cached() const noexcept
+{
+  return from_cache;
+}
+
+size_t WaveCache::mostAliens() const noexcept
+{
+  size_t most = 0;
+  for (size_t i = 0; i < wave_count; ++i)
+  {
+    most = std::max<size_t>(most, waves[i].aliens);
+  }
+  return most;
+}
+
+size_t WaveCache::mostBarriers() const noexcept
+{
+  size_t most = 0;
+  for (size_t i = 0; i < wave_count; ++i)
+  {
+    most = std::max<size_t>(most, waves[i].barrier_count);
+  }
+  return most;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "Levels/Scenario.h"
+#include "Resources/MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ *  The waves a game is played through, defined in json by designers.
+ *  The json is compiled into a flat binary blob the first time it is
+ *  loaded, and the blob saved to a cache on disk. Later loads map the
+ *  cache into memory and read the waves straight out of it, skipping
+ *  the parse entirely. The cache remembers a hash of the json it was
+ *  compiled from, so editing the waves recompiles them on the next
+ *  load and needs no rebuild.
+ *  @see Scenario
+ */
+class WaveCache
+{
+ public:
+  WaveCache() = default;
+  ~WaveCache() = default;
+
+  WaveCache(const WaveCache&) = delete;
+  WaveCache& operator=(const WaveCache&) = delete;
+
+  /**
+   *  Loads the waves, from the cache if it was compiled from the same
+   *  json, otherwise compiling the json and rewriting the cache. Should
+   *  the cache not be writable, the waves compiled are kept in memory.
+   *  @param [in] source_file The wave definitions, in the data folder
+   *  @param [in] cache_file Where the compiled waves are kept on disk
+   *  @return true if there are waves to play
+   */
+  bool load(const std::string& source_file, const std::string& cache_file);
+
+  /**
+   *  Sets up a scenario to play a wave. Only the level is replaced; the
+   *  shot pools and the rest of the session are left as they were.
+   *  @param [in] wave The wave to play
+   *  @param [in,out] scenario The scenario to play it in
+   */
+  void apply(size_t wave, Scenario& scenario) const;
+
+  size_t size() const noexcept;
+  bool empty() const noexcept;
+
+  /**
+   *  @return true if the last load read the cache without parsing
+   */
+  bool cached() const noexcept;
+
+  /** The most aliens any one wave holds. */
+  size_t mostAliens() const noexcept;
+
+  /** The most barriers any one wave places. */
+  size_t mostBarriers() const noexcept;
+
+ private:
+  struct Header
+  {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t source_hash;
+    std::uint32_t wave_count;
+    std::uint32_t barrier_count;
+  };
+
+  struct WaveRecord
+  {
+    std::uint32_t aliens;
+    std::uint32_t aliens_per_row;
+    float alien_spacing;
+    float row_spacing;
+    float left;
+    float top;
+    std::int32_t movement;
+    float speed;
+    float gravity;
+    std::uint32_t fire_interval;
+    std::uint32_t volley;
+    std::uint32_t first_barrier; /**< Into the barrier table. */
+    std::uint32_t barrier_count;
+  };
+
+  struct BarrierRecord
+  {
+    float x;
+    float y;
+  };
+
+  static bool compile(const char* json,
+                      size_t length,
+                      std::uint64_t source_hash,
+                      std::vector<std::uint8_t>& blob);
+  bool use(const std::uint8_t* blob, size_t length, std::uint64_t hash);
+
+  MappedFile cache;
+  std::vector<std::uint8_t> compiled; /**< Held when the cache is not. */
+  const WaveRecord* waves = nullptr;
+  const BarrierRecord* barriers = nullptr;
+  size_t wave_count = 0;
+  bool from_cache = false;
+};
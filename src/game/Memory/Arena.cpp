@@ -0,0 +1,77 @@
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+
+Arena::Arena(size_t block_size) : default_block_size(block_size) {}
+
+Arena::~Arena()
+{
+  reset();
+}
+
+/**
+ *   @brief   Bumps the offset into the current block.
+ *   @details When the current block is full the next retained block is
+ *            used, and only once those run out is a new one taken from
+ *            the heap. Requests larger than a block get a block sized
+ *            to fit.
+ *   @return  The aligned memory.
+ */
+void* Arena::allocate(size_t size, size_t alignment)
+{
+  while (current_block < blocks.size())
+  {
+    Block& block = blocks[current_block];
+    const auto base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+    const auto aligned = (base + offset + alignment - 1) & ~(alignment - 1);
+    const size_t start = aligned - base;
+
+    if (start + size <= block.size)
+    {
+      offset = start + size;
+      used += size;
+      return block.memory.get() + start;
+    }
+
+    ++current_block;
+    offset = 0;
+  }
+
+  Block block;
+  block.size = std::max(default_block_size, size + alignment);
+  block.memory.reset(new unsigned char[block.size]);
+  blocks.push_back(std::move(block));
+  current_block = blocks.size() - 1;
+  offset = 0;
+
+  return allocate(size, alignment);
+}
+
+void Arena::reset()
+{
+  while (finalisers != nullptr)
+  {
+    Finaliser* entry = finalisers;
+    finalisers = entry->next;
+    entry->finalise(entry->object);
+  }
+
+  current_block = 0;
+  offset = 0;
+  used = 0;
+}
+
+size_t Arena::allocations() const noexcept
+{
+  return objects_created;
+}
+
+size_t Arena::heapAllocations() const noexcept
+{
+  return blocks.size();
+}
+
+size_t Arena::bytesUsed() const noexcept
+{
+  return used;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ *  Bump allocator for objects that live as long as a level.
+ *  Objects are carved out of large blocks one after another, so those
+ *  created together sit together in memory. Nothing is freed on its
+ *  own; reset destroys every object in one pass, newest first, and
+ *  keeps the blocks for the next level, so a restarted level is built
+ *  without going back to the heap at all.
+ */
+class Arena
+{
+ public:
+  /**
+   *  @param [in] block_size The size of each block taken from the heap
+   */
+  explicit Arena(size_t block_size = 64 * 1024);
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   *  Reserves raw memory in the arena.
+   *  @param [in] size The number of bytes needed
+   *  @param [in] alignment The alignment needed, a power of two
+   *  @return the memory, valid until the arena is reset
+   */
+  void* allocate(size_t size, size_t alignment);
+
+  /**
+   *  Constructs an object in the arena. Its destructor runs when the
+   *  arena is reset.
+   *  @return the object, valid until the arena is reset
+   */
+  template <typename T, typename... Args> T* create(Args&&... args)
+  {
+    void* memory = allocate(sizeof(T), alignof(T));
+    T* object = new (memory) T(std::forward<Args>(args)...);
+
+    if (!std::is_trivially_destructible<T>::value)
+    {
+      void* entry = allocate(sizeof(Finaliser), alignof(Finaliser));
+      finalisers = new (entry) Finaliser{ &destroy<T>, object, finalisers };
+    }
+
+    ++objects_created;
+    return object;
+  }
+
+  /**
+   *  Destroys every object and rewinds to the first block.
+   */
+  void reset();
+
+  /**
+   *  The number of objects created, over the arena's whole lifetime.
+   *  @return the count of calls to create
+   */
+  size_t allocations() const noexcept;
+
+  /**
+   *  The number of blocks taken from the heap. Once the arena has
+   *  grown to fit a level this should stay the same, however many
+   *  times the level is restarted.
+   *  @return the count of heap allocations made
+   */
+  size_t heapAllocations() const noexcept;
+
+  /**
+   *  @return the bytes handed out since the last reset
+   */
+  size_t bytesUsed() const noexcept;
+
+ private:
+  struct Finaliser
+  {
+    void (*finalise)(void*);
+    void* object;
+    Finaliser* next;
+  };
+
+  template <typename T> static void destroy(void* object)
+  {
+    static_cast<T*>(object)->~T();
+  }
+
+  struct Block
+  {
+    std::unique_ptr<unsigned char[]> memory;
+    size_t size = 0;
+  };
+
+  size_t default_block_size;
+  std::vector<Block> blocks;
+  size_t current_block = 0;
+  size_t offset = 0;
+  size_t used = 0;
+  size_t objects_created = 0;
+  Finaliser* finalisers = nullptr;
+};
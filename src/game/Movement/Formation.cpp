@@ -0,0 +1,232 @@
+#include "Formation.h"
+#include <algorithm>
+
+void Formation::init(size_t columns,
+                     size_t rows,
+                     float column_spacing,
+                     float row_spacing,
+                     float slot_width,
+                     float slot_height)
+{
+  column_x.resize(columns);
+  for (size_t column = 0; column < columns; ++column)
+  {
+    column_x[column] = static_cast<float>(column) * column_spacing;
+  }
+
+  row_y.resize(rows);
+  for (size_t row = 0; row < rows; ++row)
+  {
+    row_y[row] = static_cast<float>(row) * row_spacing;
+  }
+
+  lift.assign(columns, 0.0F);
+  prev_lift.assign(columns, 0.0F);
+  path_x.resize(columns);
+
+  slot_live.assign(columns * rows, 1);
+  column_live.assign(columns, static_cast<std::uint32_t>(rows));
+  row_live.assign(rows, static_cast<std::uint32_t>(columns));
+  live_count = columns * rows;
+
+  first_column = 0;
+  last_column = columns > 0 ? static_cast<std::uint32_t>(columns - 1) : 0;
+  first_row = 0;
+  last_row = rows > 0 ? static_cast<std::uint32_t>(rows - 1) : 0;
+  min_lift = 0;
+  max_lift = 0;
+
+  width = slot_width;
+  height = slot_height;
+  transform = Transform{};
+  velocity = Velocity{};
+}
+
+/**
+ *   @brief   Empties a slot
+ *   @details When the slot was the last in an outer column or row, the
+ *            edge moves inwards past any others that are already empty.
+ *            Each column and row is passed over at most once a level.
+ *   @return  void
+ */
+void Formation::kill(std::uint32_t column, std::uint32_t row) noexcept
+{
+  const size_t slot = static_cast<size_t>(row) * column_x.size() + column;
+  if (slot >= slot_live.size() || !slot_live[slot])
+  {
+    return;
+  }
+
+  slot_live[slot] = 0;
+  --column_live[column];
+  --row_live[row];
+  if (--live_count == 0)
+  {
+    return;
+  }
+
+  while (column_live[first_column] == 0)
+  {
+    ++first_column;
+  }
+  while (column_live[last_column] == 0)
+  {
+    --last_column;
+  }
+  while (row_live[first_row] == 0)
+  {
+    ++first_row;
+  }
+  while (row_live[last_row] == 0)
+  {
+    --last_row;
+  }
+
+  if (column_live[column] == 0)
+  {
+    updateLiftBounds();
+  }
+}
+
+void Formation::storePosition() noexcept
+{
+  transform.prev_x = transform.x;
+  transform.prev_y = transform.y;
+  std::copy(lift.begin(), lift.end(), prev_lift.begin());
+}
+
+void Formation::move(float dt) noexcept
+{
+  transform.x += velocity.x * dt;
+  transform.y += velocity.y * dt;
+}
+
+/**
+ *   @brief   Lifts the columns onto a path
+ *   @details The columns' positions are packed and the path evaluated
+ *            over all of them at once.
+ *   @return  void
+ */
+void Formation::followPath(const Trajectory& path, float ahead)
+{
+  for (size_t column = 0; column < column_x.size(); ++column)
+  {
+    path_x[column] = transform.x + ahead + column_x[column];
+  }
+
+  path.evaluate(path_x.data(), lift.data(), lift.size());
+  updateLiftBounds();
+}
+
+void Formation::flatten() noexcept
+{
+  std::fill(lift.begin(), lift.end(), 0.0F);
+  min_lift = 0;
+  max_lift = 0;
+}
+
+Box Formation::bounds() const noexcept
+{
+  if (live_count == 0)
+  {
+    return Box{ transform.x, transform.y, 0, 0 };
+  }
+
+  const float left = column_x[first_column];
+  const float top = row_y[first_row] + min_lift;
+  return Box{ transform.x + left,
+              transform.y + top,
+              column_x[last_column] + width - left,
+              row_y[last_row] + max_lift + height - top };
+}
+
+Box Formation::slotBox(std::uint32_t column, std::uint32_t row) const noexcept
+{
+  return Box{ transform.x + column_x[column],
+              transform.y + row_y[row] + lift[column],
+              width,
+              height };
+}
+
+Box Formation::slotBox(std::uint32_t column,
+                       std::uint32_t row,
+                       float alpha) const noexcept
+{
+  const float x =
+    transform.prev_x + (transform.x - transform.prev_x) * alpha;
+  const float y =
+    transform.prev_y + (transform.y - transform.prev_y) * alpha;
+  const float column_lift =
+    prev_lift[column] + (lift[column] - prev_lift[column]) * alpha;
+
+  return Box{
+    x + column_x[column], y + row_y[row] + column_lift, width, height
+  };
+}
+
+bool Formation::alive(std::uint32_t column, std::uint32_t row) const noexcept
+{
+  const size_t slot = static_cast<size_t>(row) * column_x.size() + column;
+  return slot < slot_live.size() && slot_live[slot];
+}
+
+size_t Formation::live() const noexcept
+{
+  return live_count;
+}
+
+size_t Formation::columns() const noexcept
+{
+  return column_x.size();
+}
+
+size_t Formation::rows() const noexcept
+{
+  return row_y.size();
+}
+
+float Formation::slotHeight() const noexcept
+{
+  return height;
+}
+
+void Formation::writeState(SnapshotWriter& out) const
+{
+  out.write(transform);
+  out.write(velocity);
+  out.writeArray(lift.data(), lift.size());
+  out.writeArray(prev_lift.data(), prev_lift.size());
+}
+
+bool Formation::readState(SnapshotReader& in) noexcept
+{
+  if (!in.read(transform) || !in.read(velocity) ||
+      !in.readArray(lift.data(), lift.size()) ||
+      !in.readArray(prev_lift.data(), prev_lift.size()))
+  {
+    return false;
+  }
+
+  updateLiftBounds();
+  return true;
+}
+
+void Formation::updateLiftBounds() noexcept
+{
+  if (live_count == 0)
+  {
+    return;
+  }
+
+  min_lift = lift[first_column];
+  max_lift = lift[first_column];
+  for (std::uint32_t column = first_column + 1; column <= last_column;
+       ++column)
+  {
+    if (column_live[column] != 0)
+    {
+      min_lift = std::min(min_lift, lift[column]);
+      max_lift = std::max(max_lift, lift[column]);
+    }
+  }
+}
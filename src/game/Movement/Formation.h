@@ -0,0 +1,144 @@
+#pragma once
+#include "ECS/Components.h"
+#include "Movement/Trajectory.h"
+#include "Physics/Collision.h"
+#include "Replay/Snapshot.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ *  The invading block, moved as one.
+ *  The block has a single transform and every alien sits in a slot at a
+ *  fixed offset from it, so moving the block costs the same however
+ *  many aliens it holds. Curved paths lift each column by its own
+ *  amount, which costs one evaluation per column. The bounds of the
+ *  live slots are kept up to date as slots are emptied: counting the
+ *  live slots in each column and row means only a death that empties
+ *  an outer column or row has to look for the new edge.
+ */
+class Formation
+{
+ public:
+  Formation() = default;
+  ~Formation() = default;
+
+  /**
+   *  Lays out a full grid of slots, every one of them live.
+   *  @param [in] columns The number of columns
+   *  @param [in] rows The number of rows
+   *  @param [in] column_spacing The distance between columns
+   *  @param [in] row_spacing The distance between rows
+   *  @param [in] slot_width The width of an alien
+   *  @param [in] slot_height The height of an alien
+   */
+  void init(size_t columns,
+            size_t rows,
+            float column_spacing,
+            float row_spacing,
+            float slot_width,
+            float slot_height);
+
+  /**
+   *  Empties a slot. Emptying it twice is harmless.
+   *  @param [in] column The slot's column
+   *  @param [in] row The slot's row
+   */
+  void kill(std::uint32_t column, std::uint32_t row) noexcept;
+
+  /**
+   *  Records the block's position as the previous tick's.
+   */
+  void storePosition() noexcept;
+
+  /**
+   *  Moves the block by its velocity.
+   *  @param [in] dt The length of the tick, in seconds
+   */
+  void move(float dt) noexcept;
+
+  /**
+   *  Lifts each column to a path's height under it.
+   *  @param [in] path The path to follow
+   *  @param [in] ahead How far along x to look past the block's position
+   */
+  void followPath(const Trajectory& path, float ahead);
+
+  /**
+   *  Drops any lift from a path, leaving the block flat.
+   */
+  void flatten() noexcept;
+
+  /**
+   *  The bounds of the live slots, empty at the block's position when
+   *  none are left.
+   */
+  Box bounds() const noexcept;
+
+  /**
+   *  Where a slot is this tick.
+   *  @param [in] column The slot's column
+   *  @param [in] row The slot's row
+   *  @return the slot's bounds
+   */
+  Box slotBox(std::uint32_t column, std::uint32_t row) const noexcept;
+
+  /**
+   *  Where a slot is, interpolated between the previous and current
+   *  tick.
+   *  @param [in] column The slot's column
+   *  @param [in] row The slot's row
+   *  @param [in] alpha How far the frame is towards the current tick
+   *  @return the slot's bounds
+   */
+  Box slotBox(std::uint32_t column,
+              std::uint32_t row,
+              float alpha) const noexcept;
+
+  bool alive(std::uint32_t column, std::uint32_t row) const noexcept;
+  size_t live() const noexcept;
+  size_t columns() const noexcept;
+  size_t rows() const noexcept;
+  float slotHeight() const noexcept;
+
+  /**
+   *  Saves where the block is and how its columns are lifted. Which
+   *  slots are live is left to the caller, who kills them again.
+   *  @param [in] out The snapshot written to
+   */
+  void writeState(SnapshotWriter& out) const;
+
+  /**
+   *  Restores what writeState saved, once the same slots are live.
+   *  @param [in] in The snapshot read from
+   *  @return false if the snapshot is of a block of another width
+   */
+  bool readState(SnapshotReader& in) noexcept;
+
+  Transform transform;
+  Velocity velocity;
+
+ private:
+  void updateLiftBounds() noexcept;
+
+  std::vector<float> column_x; /**< Offset of each column from the block. */
+  std::vector<float> row_y;    /**< Offset of each row from the block. */
+  std::vector<float> lift;
+  std::vector<float> prev_lift;
+  std::vector<float> path_x; /**< Scratch for evaluating paths. */
+
+  std::vector<std::uint8_t> slot_live;
+  std::vector<std::uint32_t> column_live;
+  std::vector<std::uint32_t> row_live;
+  size_t live_count = 0;
+
+  // the outermost columns and rows with a live slot, inclusive
+  std::uint32_t first_column = 0;
+  std::uint32_t last_column = 0;
+  std::uint32_t first_row = 0;
+  std::uint32_t last_row = 0;
+  float min_lift = 0;
+  float max_lift = 0;
+
+  float width = 0;
+  float height = 0;
+};
@@ -0,0 +1,96 @@
+#include "Trajectory.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+float sineRise(float x) noexcept
+{
+  return SINE_AMPLITUDE * std::sin(SINE_FREQUENCY * x);
+}
+
+float Trajectory::operator()(float x) const noexcept
+{
+  float y = 0;
+  evaluate(&x, &y, 1);
+  return y;
+}
+
+PolynomialTrajectory::PolynomialTrajectory(std::vector<float> polynomial,
+                                           float polynomial_origin) :
+  coefficients(std::move(polynomial)),
+  origin(polynomial_origin)
+{
+}
+
+/**
+ *   @brief   Evaluates the polynomial at each position
+ *   @details Horner's rule, applied a term at a time across the whole
+ *            batch, so each pass is a multiply and add over packed
+ *            floats that the compiler can vectorise.
+ *   @return  void
+ */
+void PolynomialTrajectory::evaluate(const float* x,
+                                    float* y,
+                                    size_t count) const noexcept
+{
+  if (coefficients.empty())
+  {
+    std::fill(y, y + count, 0.0F);
+    return;
+  }
+
+  std::fill(y, y + count, coefficients.back());
+
+  for (size_t term = coefficients.size() - 1; term-- > 0;)
+  {
+    const float coefficient = coefficients[term];
+    for (size_t i = 0; i < count; ++i)
+    {
+      y[i] = y[i] * (x[i] - origin) + coefficient;
+    }
+  }
+}
+
+TableTrajectory::TableTrajectory(const std::function<float(float)>& function,
+                                 float period,
+                                 size_t samples) :
+  table(samples + 1),
+  samples_per_unit(static_cast<float>(samples) / period)
+{
+  for (size_t i = 0; i < samples; ++i)
+  {
+    table[i] = function(period * static_cast<float>(i) /
+                        static_cast<float>(samples));
+  }
+  table[samples] = table[0];
+}
+
+/**
+ *   @brief   Looks each position up in the table
+ *   @details Positions outside the first period wrap around, negative
+ *            ones included.
+ *   @return  void
+ */
+void TableTrajectory::evaluate(const float* x,
+                               float* y,
+                               size_t count) const noexcept
+{
+  const auto samples = static_cast<long>(table.size() - 1);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const float position = x[i] * samples_per_unit;
+    const float whole = std::floor(position);
+    const float fraction = position - whole;
+
+    long sample = static_cast<long>(whole) % samples;
+    if (sample < 0)
+    {
+      sample += samples;
+    }
+
+    const float from = table[static_cast<size_t>(sample)];
+    const float to = table[static_cast<size_t>(sample) + 1];
+    y[i] = from + (to - from) * fraction;
+  }
+}
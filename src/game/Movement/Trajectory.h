@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+constexpr float PI = 3.14159265F;
+
+// the curves the formation follows, shared by the game and its benchmark:
+// y = QUADRATIC_CURVE (x - QUADRATIC_ORIGIN)^2 + QUADRATIC_HEIGHT and a
+// rise rate of SINE_AMPLITUDE sin(SINE_FREQUENCY x)
+constexpr float QUADRATIC_ORIGIN = 640.0F;
+constexpr float QUADRATIC_HEIGHT = 200.0F;
+constexpr float QUADRATIC_CURVE = -0.0002F;
+constexpr float SINE_AMPLITUDE = 50.0F;
+constexpr float SINE_FREQUENCY = 0.01F;
+constexpr float SINE_PERIOD = 2 * PI / SINE_FREQUENCY;
+constexpr size_t SINE_SAMPLES = 1024;
+
+/**
+ *  The rise rate of the sine path, sampled into its table.
+ *  @param [in] x The position
+ *  @return the rate the formation rises at x
+ */
+float sineRise(float x) noexcept;
+
+/**
+ *  A path for the formation to follow, giving a height for every x.
+ *  Paths are evaluated over packed arrays of positions, so choosing the
+ *  path costs one virtual call per batch rather than one per alien. New
+ *  kinds of path derive from this and implement evaluate.
+ */
+class Trajectory
+{
+ public:
+  Trajectory() = default;
+  virtual ~Trajectory() = default;
+
+  Trajectory(const Trajectory&) = delete;
+  Trajectory& operator=(const Trajectory&) = delete;
+
+  /**
+   *  Evaluates the path at a batch of positions.
+   *  @param [in] x The positions to evaluate the path at
+   *  @param [out] y The heights, which must not overlap x
+   *  @param [in] count The number of positions
+   */
+  virtual void
+  evaluate(const float* x, float* y, size_t count) const noexcept = 0;
+
+  /**
+   *  Evaluates the path at a single position.
+   *  @param [in] x The position
+   *  @return the height of the path at x
+   */
+  float operator()(float x) const noexcept;
+};
+
+/**
+ *  A polynomial path, evaluated in closed form by Horner's rule.
+ */
+class PolynomialTrajectory final : public Trajectory
+{
+ public:
+  /**
+   *  The path c0 + c1 u + c2 u^2 + ..., where u = x - origin.
+   *  @param [in] coefficients The coefficients, constant term first
+   *  @param [in] origin The position u is measured from
+   */
+  PolynomialTrajectory(std::vector<float> coefficients, float origin);
+
+  void evaluate(const float* x, float* y, size_t count) const
+    noexcept override;
+
+ private:
+  std::vector<float> coefficients;
+  float origin = 0;
+};
+
+/**
+ *  A periodic path sampled into a table once, up front. Evaluating it
+ *  interpolates linearly between the two nearest samples, so it costs
+ *  the same whatever the function sampled.
+ */
+class TableTrajectory final : public Trajectory
+{
+ public:
+  /**
+   *  @param [in] function The path over one period, starting at zero
+   *  @param [in] period The distance over which the path repeats
+   *  @param [in] samples The number of samples taken over a period
+   */
+  TableTrajectory(const std::function<float(float)>& function,
+                  float period,
+                  size_t samples);
+
+  void evaluate(const float* x, float* y, size_t count) const
+    noexcept override;
+
+ private:
+  std::vector<float> table; /**< One extra sample, so i + 1 never wraps. */
+  float samples_per_unit = 0;
+};
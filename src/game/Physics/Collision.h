@@ -0,0 +1,42 @@
+#pragma once
+#include <algorithm>
+
+/**
+ *  An axis aligned bounding box.
+ *  Uses the same top-left origin and dimensions as ASGE sprites.
+ */
+struct Box
+{
+  float x = 0;
+  float y = 0;
+  float width = 0;
+  float height = 0;
+};
+
+/**
+ *  Tests whether two boxes overlap. Touching edges count as overlapping.
+ *  @param [in] a The first box
+ *  @param [in] b The second box
+ *  @return true if the boxes intersect
+ */
+inline bool overlaps(const Box& a, const Box& b) noexcept
+{
+  return (b.x <= a.x + a.width) && (b.x + b.width >= a.x) &&
+         (b.y <= a.y + a.height) && (b.y + b.height >= a.y);
+}
+
+/**
+ *  The smallest box containing both boxes.
+ *  @param [in] a The first box
+ *  @param [in] b The second box
+ *  @return the union of the two boxes
+ */
+inline Box merge(const Box& a, const Box& b) noexcept
+{
+  const float min_x = std::min(a.x, b.x);
+  const float min_y = std::min(a.y, b.y);
+  return Box{ min_x,
+              min_y,
+              std::max(a.x + a.width, b.x + b.width) - min_x,
+              std::max(a.y + a.height, b.y + b.height) - min_y };
+}
@@ -0,0 +1,93 @@
+#include "OverlapKernel.h"
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#endif
+
+namespace
+{
+  std::uint64_t overlapScalar(const Box& box,
+                              const float* x,
+                              const float* y,
+                              const float* width,
+                              const float* height,
+                              size_t first,
+                              size_t count) noexcept
+  {
+    std::uint64_t mask = 0;
+    for (size_t i = first; i < count; ++i)
+    {
+      if (overlaps(box, Box{ x[i], y[i], width[i], height[i] }))
+      {
+        mask |= std::uint64_t{ 1 } << i;
+      }
+    }
+    return mask;
+  }
+}
+
+/**
+ *   @brief   Tests one box against up to 64 packed boxes.
+ *   @details The four edge tests are done lane-wise and combined, then
+ *            the lane results are packed into the mask. Whatever does
+ *            not fill a full vector is finished off by the scalar test.
+ *   @return  A bitmask of the packed boxes that overlap.
+ */
+std::uint64_t overlapMask(const Box& box,
+                          const float* x,
+                          const float* y,
+                          const float* width,
+                          const float* height,
+                          size_t count) noexcept
+{
+  std::uint64_t mask = 0;
+  size_t i = 0;
+
+#if defined(__AVX__)
+  const __m256 left = _mm256_set1_ps(box.x);
+  const __m256 right = _mm256_set1_ps(box.x + box.width);
+  const __m256 top = _mm256_set1_ps(box.y);
+  const __m256 bottom = _mm256_set1_ps(box.y + box.height);
+
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 bx = _mm256_loadu_ps(x + i);
+    const __m256 by = _mm256_loadu_ps(y + i);
+    const __m256 bw = _mm256_loadu_ps(width + i);
+    const __m256 bh = _mm256_loadu_ps(height + i);
+
+    __m256 hit = _mm256_cmp_ps(bx, right, _CMP_LE_OQ);
+    hit = _mm256_and_ps(
+      hit, _mm256_cmp_ps(_mm256_add_ps(bx, bw), left, _CMP_GE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(by, bottom, _CMP_LE_OQ));
+    hit = _mm256_and_ps(
+      hit, _mm256_cmp_ps(_mm256_add_ps(by, bh), top, _CMP_GE_OQ));
+
+    mask |= static_cast<std::uint64_t>(_mm256_movemask_ps(hit)) << i;
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128 left = _mm_set1_ps(box.x);
+  const __m128 right = _mm_set1_ps(box.x + box.width);
+  const __m128 top = _mm_set1_ps(box.y);
+  const __m128 bottom = _mm_set1_ps(box.y + box.height);
+
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 bx = _mm_loadu_ps(x + i);
+    const __m128 by = _mm_loadu_ps(y + i);
+    const __m128 bw = _mm_loadu_ps(width + i);
+    const __m128 bh = _mm_loadu_ps(height + i);
+
+    __m128 hit = _mm_cmple_ps(bx, right);
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_add_ps(bx, bw), left));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(by, bottom));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_add_ps(by, bh), top));
+
+    mask |= static_cast<std::uint64_t>(_mm_movemask_ps(hit)) << i;
+  }
+#endif
+
+  return mask | overlapScalar(box, x, y, width, height, i, count);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Collision.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ *  The number of boxes tested by a single call to overlapMask.
+ */
+constexpr size_t OVERLAP_BATCH = 64;
+
+/**
+ *  Tests one box against a packed array of boxes.
+ *  The boxes are given as separate x, y, width and height arrays, as
+ *  stored by PackedColliders. Uses AVX or SSE when the compiler targets
+ *  them, falling back to scalar tests otherwise. Touching edges count
+ *  as overlapping, exactly as overlaps() does.
+ *  @param [in] box The box to test
+ *  @param [in] x The left edges of the packed boxes
+ *  @param [in] y The top edges of the packed boxes
+ *  @param [in] width The widths of the packed boxes
+ *  @param [in] height The heights of the packed boxes
+ *  @param [in] count The number of packed boxes, at most OVERLAP_BATCH
+ *  @return a mask with bit i set if box overlaps packed box i
+ */
+std::uint64_t overlapMask(const Box& box,
+                          const float* x,
+                          const float* y,
+                          const float* width,
+                          const float* height,
+                          size_t count) noexcept;
+
+/**
+ *  Index of the lowest set bit in a non-zero mask.
+ *  @param [in] mask The hit mask returned by overlapMask
+ *  @return the position of the lowest set bit
+ */
+inline size_t lowestBit(std::uint64_t mask) noexcept
+{
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_ctzll(mask));
+#else
+  size_t bit = 0;
+  while (!(mask & 1U))
+  {
+    mask >>= 1U;
+    ++bit;
+  }
+  return bit;
+#endif
+}
@@ -0,0 +1,125 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  constexpr std::uint32_t LAYER_SHIFT = 24;
+  constexpr std::uint32_t INDEX_MASK = (1U << LAYER_SHIFT) - 1;
+}
+
+SpatialHash::SpatialHash(float cell_size, std::uint32_t buckets_wanted) :
+  inverse_cell_size(1.0F / cell_size)
+{
+  std::uint32_t bucket_count = 1;
+  while (bucket_count < buckets_wanted)
+  {
+    bucket_count <<= 1U;
+  }
+
+  bucket_mask = bucket_count - 1;
+  buckets.resize(bucket_count);
+}
+
+std::uint32_t SpatialHash::id(std::uint32_t layer, std::uint32_t index) noexcept
+{
+  return (layer << LAYER_SHIFT) | (index & INDEX_MASK);
+}
+
+std::uint32_t SpatialHash::layerOf(std::uint32_t id) noexcept
+{
+  return id >> LAYER_SHIFT;
+}
+
+std::uint32_t SpatialHash::indexOf(std::uint32_t id) noexcept
+{
+  return id & INDEX_MASK;
+}
+
+void SpatialHash::reserve(size_t entries_per_bucket)
+{
+  for (auto& bucket : buckets)
+  {
+    bucket.reserve(entries_per_bucket);
+  }
+  occupied.reserve(buckets.size());
+}
+
+void SpatialHash::clear()
+{
+  for (auto bucket : occupied)
+  {
+    buckets[bucket].clear();
+  }
+  occupied.clear();
+}
+
+void SpatialHash::insert(std::uint32_t entity_id, const Box& box)
+{
+  const int min_x = cellOf(box.x);
+  const int max_x = cellOf(box.x + box.width);
+  const int min_y = cellOf(box.y);
+  const int max_y = cellOf(box.y + box.height);
+
+  for (int cell_y = min_y; cell_y <= max_y; ++cell_y)
+  {
+    for (int cell_x = min_x; cell_x <= max_x; ++cell_x)
+    {
+      const auto bucket_index = bucketIndex(cell_x, cell_y);
+      auto& bucket = buckets[bucket_index];
+
+      if (bucket.empty())
+      {
+        occupied.push_back(bucket_index);
+      }
+
+      // a box spanning cells that hash together only needs one entry
+      if (bucket.empty() || bucket.back() != entity_id)
+      {
+        bucket.push_back(entity_id);
+      }
+    }
+  }
+}
+
+void SpatialHash::query(const Box& box,
+                        std::vector<std::uint32_t>& candidates) const
+{
+  candidates.clear();
+
+  const int min_x = cellOf(box.x);
+  const int max_x = cellOf(box.x + box.width);
+  const int min_y = cellOf(box.y);
+  const int max_y = cellOf(box.y + box.height);
+
+  for (int cell_y = min_y; cell_y <= max_y; ++cell_y)
+  {
+    for (int cell_x = min_x; cell_x <= max_x; ++cell_x)
+    {
+      const auto& bucket = buckets[bucketIndex(cell_x, cell_y)];
+      candidates.insert(candidates.end(), bucket.begin(), bucket.end());
+    }
+  }
+
+  if (min_x == max_x && min_y == max_y)
+  {
+    return;
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+}
+
+std::uint32_t SpatialHash::bucketIndex(int cell_x, int cell_y) const noexcept
+{
+  // large primes spread neighbouring cells across the buckets
+  const auto hash = (static_cast<std::uint32_t>(cell_x) * 73856093U) ^
+                    (static_cast<std::uint32_t>(cell_y) * 19349663U);
+  return hash & bucket_mask;
+}
+
+int SpatialHash::cellOf(float position) const noexcept
+{
+  return static_cast<int>(std::floor(position * inverse_cell_size));
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Collision.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ *  Uniform grid broad phase for collision detection.
+ *  Boxes are inserted into every cell they touch, and cells are hashed
+ *  into a fixed number of buckets so the world does not need bounds.
+ *  Queries return the ids of everything sharing a bucket with the
+ *  query box; these are only candidates and still need a narrow phase
+ *  test. The grid is cheap to clear and is rebuilt every tick, bucket
+ *  memory is kept between rebuilds so steady state does not allocate.
+ */
+class SpatialHash
+{
+ public:
+  /**
+   *  Constructor.
+   *  @param [in] cell_size The width and height of a grid cell in pixels
+   *  @param [in] buckets The number of buckets, rounded up to a power of two
+   */
+  explicit SpatialHash(float cell_size = 64.0F, std::uint32_t buckets = 1024);
+
+  /**
+   *  Packs a collision layer and an entity index into a single id.
+   *  @param [in] layer The layer, up to 255
+   *  @param [in] index The index of the entity in its store
+   *  @return the id to insert into the grid
+   */
+  static std::uint32_t id(std::uint32_t layer, std::uint32_t index) noexcept;
+  static std::uint32_t layerOf(std::uint32_t id) noexcept;
+  static std::uint32_t indexOf(std::uint32_t id) noexcept;
+
+  /**
+   *  Reserves room in every bucket up front, so the grid never
+   *  allocates while no bucket holds more entries than that.
+   *  @param [in] entries_per_bucket The most entries expected in a bucket
+   */
+  void reserve(size_t entries_per_bucket);
+
+  /**
+   *  Empties every bucket while keeping their memory.
+   */
+  void clear();
+
+  /**
+   *  Adds a box to every cell it covers.
+   *  @param [in] entity_id The id returned by SpatialHash::id
+   *  @param [in] box The bounds of the entity
+   */
+  void insert(std::uint32_t entity_id, const Box& box);
+
+  /**
+   *  Finds the ids of everything that may overlap the box.
+   *  Each candidate is reported once, in no particular order.
+   *  @param [in] box The area to search
+   *  @param [out] candidates Cleared and filled with the matching ids
+   */
+  void query(const Box& box, std::vector<std::uint32_t>& candidates) const;
+
+ private:
+  std::uint32_t bucketIndex(int cell_x, int cell_y) const noexcept;
+  int cellOf(float position) const noexcept;
+
+  float inverse_cell_size = 0;
+  std::uint32_t bucket_mask = 0;
+  std::vector<std::vector<std::uint32_t>> buckets;
+  std::vector<std::uint32_t> occupied;
+};
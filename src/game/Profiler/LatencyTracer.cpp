@@ -0,0 +1,204 @@
+#include "LatencyTracer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <string>
+
+namespace
+{
+  const size_t HISTOGRAM_BUCKETS = 24;
+  const size_t HISTOGRAM_WIDTH = 40;
+
+  double micros(std::int64_t nanoseconds) noexcept
+  {
+    return static_cast<double>(nanoseconds) / 1000.0;
+  }
+
+  double percentile(std::vector<double>& sorted, double fraction) noexcept
+  {
+    const auto rank = static_cast<size_t>(
+      fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[rank];
+  }
+
+  void reportStage(std::ostream& out,
+                   const char* name,
+                   std::vector<double> durations)
+  {
+    std::sort(durations.begin(), durations.end());
+    out << std::left << std::setw(10) << name << std::right << std::fixed
+        << std::setprecision(1) << std::setw(12)
+        << percentile(durations, 0.5) << std::setw(12)
+        << percentile(durations, 0.9) << std::setw(12)
+        << percentile(durations, 0.99) << std::setw(12) << durations.back()
+        << std::endl;
+  }
+
+  /**
+   *  Buckets double in width, so bucket i holds durations from 2^(i-1)
+   *  up to 2^i microseconds and bucket 0 everything under a microsecond.
+   */
+  size_t bucket(double microseconds) noexcept
+  {
+    size_t index = 0;
+    for (double limit = 1; microseconds >= limit; limit *= 2)
+    {
+      ++index;
+    }
+    return std::min(index, HISTOGRAM_BUCKETS - 1);
+  }
+}
+
+void LatencyTracer::enable(size_t expected_inputs)
+{
+  active = true;
+  pending.reserve(expected_inputs);
+  in_flight.reserve(expected_inputs);
+  samples.reserve(expected_inputs);
+}
+
+bool LatencyTracer::enabled() const noexcept
+{
+  return active;
+}
+
+void LatencyTracer::applied(std::int64_t key_time, unsigned long long tick)
+{
+  Pending input;
+  input.trace.id = ++next_id;
+  input.trace.key_time = key_time;
+  input.trace.apply_time = Profiler::now();
+  input.tick = tick;
+  pending.push_back(input);
+}
+
+/**
+ *   @brief   Tags the frame being written
+ *   @details A frame the renderer skips never shows its inputs, so tags
+ *            stay pending until a frame carrying them has been drawn,
+ *            and are added to every frame written until then. Each
+ *            keeps the time of the first frame written to show it.
+ *   @return  void
+ */
+void LatencyTracer::write(unsigned long long tick, FramePacket& packet)
+{
+  const unsigned long long drawn =
+    last_rendered.load(std::memory_order_acquire);
+  pending.erase(std::remove_if(pending.begin(),
+                               pending.end(),
+                               [drawn](const Pending& input) {
+                                 return input.trace.id <= drawn;
+                               }),
+                pending.end());
+
+  const std::int64_t now = Profiler::now();
+  for (Pending& input : pending)
+  {
+    if (input.tick < tick)
+    {
+      if (input.trace.write_time == 0)
+      {
+        input.trace.write_time = now;
+      }
+      packet.traces.push_back(input.trace);
+    }
+  }
+}
+
+void LatencyTracer::rendered(const FramePacket& packet)
+{
+  const std::int64_t now = Profiler::now();
+  unsigned long long drawn = last_rendered.load(std::memory_order_relaxed);
+  for (const InputTrace& trace : packet.traces)
+  {
+    if (trace.id > drawn)
+    {
+      Sample sample;
+      sample.trace = trace;
+      sample.render_time = now;
+      in_flight.push_back(sample);
+      drawn = trace.id;
+    }
+  }
+
+  last_rendered.store(drawn, std::memory_order_release);
+}
+
+void LatencyTracer::presented()
+{
+  const std::int64_t now = Profiler::now();
+  for (Sample& sample : in_flight)
+  {
+    sample.present_time = now;
+    samples.push_back(sample);
+  }
+  in_flight.clear();
+}
+
+/**
+ *   @brief   Reports the traced inputs
+ *   @details The stages are the wait in the input queue, simulating
+ *            until a frame shows the input, the wait for that frame to
+ *            be drawn, and the wait for the swap. All in microseconds.
+ *   @return  void
+ */
+void LatencyTracer::report(std::ostream& out) const
+{
+  out << "input latency over " << samples.size() << " inputs" << std::endl;
+  if (samples.empty())
+  {
+    return;
+  }
+
+  std::vector<double> queue;
+  std::vector<double> simulate;
+  std::vector<double> render;
+  std::vector<double> present;
+  std::vector<double> total;
+  for (const Sample& sample : samples)
+  {
+    const InputTrace& trace = sample.trace;
+    queue.push_back(micros(trace.apply_time - trace.key_time));
+    simulate.push_back(micros(trace.write_time - trace.apply_time));
+    render.push_back(micros(sample.render_time - trace.write_time));
+    present.push_back(micros(sample.present_time - sample.render_time));
+    total.push_back(micros(sample.present_time - trace.key_time));
+  }
+
+  out << std::left << std::setw(10) << "stage" << std::right << std::setw(12)
+      << "p50 us" << std::setw(12) << "p90 us" << std::setw(12) << "p99 us"
+      << std::setw(12) << "max us" << std::endl;
+  reportStage(out, "queue", queue);
+  reportStage(out, "simulate", simulate);
+  reportStage(out, "render", render);
+  reportStage(out, "present", present);
+  reportStage(out, "total", total);
+
+  size_t counts[HISTOGRAM_BUCKETS] = {};
+  for (const double duration : total)
+  {
+    ++counts[bucket(duration)];
+  }
+
+  const size_t most = *std::max_element(counts, counts + HISTOGRAM_BUCKETS);
+  size_t first = 0;
+  size_t last = HISTOGRAM_BUCKETS - 1;
+  while (counts[first] == 0)
+  {
+    ++first;
+  }
+  while (counts[last] == 0)
+  {
+    --last;
+  }
+
+  out << "total" << std::endl;
+  for (size_t i = first; i <= last; ++i)
+  {
+    const std::string label = "<" + std::to_string(1ULL << i) + "us";
+    out << std::setw(10) << label << " " << std::left
+        << std::setw(static_cast<int>(HISTOGRAM_WIDTH))
+        << std::string(counts[i] * HISTOGRAM_WIDTH / most, '#') << std::right
+        << std::setw(8) << counts[i] << std::endl;
+  }
+}
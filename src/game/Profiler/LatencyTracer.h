@@ -0,0 +1,91 @@
+#pragma once
+#include "Rendering/FramePacket.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ *  Measures how long each input takes to reach the screen.
+ *  Inputs that move the defender or fire are tagged when they are
+ *  applied, and the tag rides in the first frame packet written after a
+ *  tick has simulated them. Render notes when that frame's sprites have
+ *  been submitted, and the frame counts as presented once the buffers
+ *  have been swapped. Tracing is opt-in and costs nothing until enabled.
+ *  The simulation calls applied and write, the render thread rendered
+ *  and presented.
+ *  @see InputTrace
+ */
+class LatencyTracer
+{
+ public:
+  LatencyTracer() = default;
+  ~LatencyTracer() = default;
+
+  LatencyTracer(const LatencyTracer&) = delete;
+  LatencyTracer& operator=(const LatencyTracer&) = delete;
+
+  /**
+   *  Starts tracing. Call before the game runs.
+   *  @param [in] expected_inputs Inputs to reserve room for up front
+   */
+  void enable(size_t expected_inputs);
+  bool enabled() const noexcept;
+
+  /**
+   *  Tags an input that has just been applied.
+   *  @param [in] key_time When the input was delivered
+   *  @param [in] tick The tick the input was applied before
+   */
+  void applied(std::int64_t key_time, unsigned long long tick);
+
+  /**
+   *  Adds the tags of every input simulated by now, but not yet drawn,
+   *  to the frame being written.
+   *  @param [in] tick The number of ticks simulated
+   *  @param [out] packet The frame being written
+   */
+  void write(unsigned long long tick, FramePacket& packet);
+
+  /**
+   *  Notes that a frame's sprites have been submitted to the renderer.
+   *  @param [in] packet The frame drawn
+   */
+  void rendered(const FramePacket& packet);
+
+  /**
+   *  Notes that the frames rendered since the last call are on screen.
+   */
+  void presented();
+
+  /**
+   *  Writes each stage's percentiles and a histogram of the total.
+   *  @param [in] out Where the report is written
+   */
+  void report(std::ostream& out) const;
+
+ private:
+  struct Pending
+  {
+    InputTrace trace;
+    unsigned long long tick = 0;
+  };
+
+  struct Sample
+  {
+    InputTrace trace;
+    std::int64_t render_time = 0;
+    std::int64_t present_time = 0;
+  };
+
+  bool active = false;
+
+  // simulation only
+  unsigned long long next_id = 0;
+  std::vector<Pending> pending;
+
+  // render only, apart from the last id drawn
+  std::atomic<unsigned long long> last_rendered{ 0 };
+  std::vector<Sample> in_flight;
+  std::vector<Sample> samples;
+};
@@ -0,0 +1,208 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+  const auto EPOCH = std::chrono::steady_clock::now();
+}
+
+/**
+ *  Holds a thread's ring, handing it back to the profiler when the
+ *  thread exits.
+ */
+class Profiler::ThreadRing
+{
+ public:
+  ThreadRing() = default;
+  ~ThreadRing()
+  {
+    if (buffer != nullptr)
+    {
+      Profiler::getInstance().release(*buffer);
+    }
+  }
+
+  ThreadRing(const ThreadRing&) = delete;
+  ThreadRing& operator=(const ThreadRing&) = delete;
+
+  ZoneBuffer* buffer = nullptr;
+};
+
+ZoneBuffer::ZoneBuffer(unsigned int thread_id) noexcept : thread(thread_id) {}
+
+void ZoneBuffer::push(const char* name,
+                      std::int64_t start,
+                      std::int64_t end) noexcept
+{
+  const auto index = head.load(std::memory_order_relaxed);
+  Slot& slot = slots[index % CAPACITY];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.start.store(start, std::memory_order_relaxed);
+  slot.end.store(end, std::memory_order_relaxed);
+  head.store(index + 1, std::memory_order_release);
+}
+
+/**
+ *   @brief   Copies the ring.
+ *   @details The head is read again after copying. Any slot the
+ *            writer could have reused in the meantime is discarded
+ *            rather than reported with a mix of old and new values.
+ *   @return  void
+ */
+void ZoneBuffer::snapshot(std::vector<ZoneSample>& samples) const
+{
+  const auto last = head.load(std::memory_order_acquire);
+  const auto first = last > CAPACITY ? last - CAPACITY : 0;
+
+  const size_t copied_from = samples.size();
+  for (auto index = first; index < last; ++index)
+  {
+    const Slot& slot = slots[index % CAPACITY];
+
+    ZoneSample sample;
+    sample.name = slot.name.load(std::memory_order_relaxed);
+    sample.start = slot.start.load(std::memory_order_relaxed);
+    sample.end = slot.end.load(std::memory_order_relaxed);
+    sample.thread = thread;
+    samples.push_back(sample);
+  }
+
+  // the writer may also be part way through the slot after its head
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto written = head.load(std::memory_order_relaxed) + 1;
+  const auto reused = written > CAPACITY ? written - CAPACITY : 0;
+  const auto overwritten = std::min(std::max(reused, first), last) - first;
+
+  samples.erase(samples.begin() + static_cast<std::ptrdiff_t>(copied_from),
+                samples.begin() +
+                  static_cast<std::ptrdiff_t>(copied_from + overwritten));
+}
+
+Profiler& Profiler::getInstance()
+{
+  static Profiler instance;
+  return instance;
+}
+
+std::int64_t Profiler::now() noexcept
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now() - EPOCH)
+    .count();
+}
+
+void Profiler::record(const char* name,
+                      std::int64_t start,
+                      std::int64_t end) noexcept
+{
+  threadBuffer().push(name, start, end);
+}
+
+/**
+ *   @brief   The calling thread's ring.
+ *   @details Only a thread's first zone takes the lock, to reuse the
+ *            ring of a thread that has exited or, failing that, to
+ *            register a new one. A reused ring keeps its zones and its
+ *            track until the new thread records over them, so the
+ *            profiler only grows with the threads alive at once.
+ *   @return  The ring to record in.
+ */
+ZoneBuffer& Profiler::threadBuffer()
+{
+  thread_local ThreadRing ring;
+  if (ring.buffer == nullptr)
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    if (!free_buffers.empty())
+    {
+      ring.buffer = free_buffers.back();
+      free_buffers.pop_back();
+    }
+    else
+    {
+      buffers.emplace_back(
+        new ZoneBuffer(static_cast<unsigned int>(buffers.size())));
+      ring.buffer = buffers.back().get();
+    }
+  }
+  return *ring.buffer;
+}
+
+void Profiler::release(ZoneBuffer& buffer)
+{
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  free_buffers.push_back(&buffer);
+}
+
+std::vector<ZoneSample> Profiler::samples() const
+{
+  std::vector<ZoneSample> all;
+
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  for (const auto& buffer : buffers)
+  {
+    buffer->snapshot(all);
+  }
+  return all;
+}
+
+void Profiler::summarise(std::int64_t since,
+                         std::vector<ZoneStats>& stats) const
+{
+  stats.clear();
+  for (const auto& sample : samples())
+  {
+    if (sample.end < since)
+    {
+      continue;
+    }
+
+    auto entry =
+      std::find_if(stats.begin(), stats.end(), [&](const ZoneStats& zone) {
+        return std::strcmp(zone.name, sample.name) == 0;
+      });
+    if (entry == stats.end())
+    {
+      entry = stats.insert(stats.end(), ZoneStats());
+      entry->name = sample.name;
+    }
+
+    const double ms = static_cast<double>(sample.end - sample.start) / 1e6;
+    entry->calls++;
+    entry->total_ms += ms;
+    entry->max_ms = std::max(entry->max_ms, ms);
+  }
+}
+
+/**
+ *   @brief   Exports a Chrome trace.
+ *   @details Each zone becomes a complete ("X") event, timed in
+ *            microseconds, on a track per thread.
+ *   @return  True if the file was written.
+ */
+bool Profiler::exportTrace(const std::string& file_name) const
+{
+  auto events = nlohmann::json::array();
+  for (const auto& sample : samples())
+  {
+    events.push_back({ { "name", sample.name },
+                       { "ph", "X" },
+                       { "ts", static_cast<double>(sample.start) / 1e3 },
+                       { "dur",
+                         static_cast<double>(sample.end - sample.start) / 1e3 },
+                       { "pid", 0 },
+                       { "tid", sample.thread } });
+  }
+
+  nlohmann::json trace;
+  trace["traceEvents"] = events;
+  trace["displayTimeUnit"] = "ms";
+
+  std::ofstream file(file_name);
+  file << trace.dump();
+  return file.good();
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ *  A completed timing zone.
+ */
+struct ZoneSample
+{
+  const char* name = nullptr;
+  std::int64_t start = 0; /**< Nanoseconds since the profiler started. */
+  std::int64_t end = 0;
+  unsigned int thread = 0;
+};
+
+/**
+ *  Timing of one zone, summed over a window of samples.
+ */
+struct ZoneStats
+{
+  const char* name = nullptr;
+  unsigned int calls = 0;
+  double total_ms = 0;
+  double max_ms = 0;
+};
+
+/**
+ *  Fixed size ring of the zones completed on one thread.
+ *  Only the owning thread writes, so pushing a zone is a few relaxed
+ *  stores and a release of the head. Readers copy the ring and drop
+ *  anything the writer lapped while they were copying, so neither side
+ *  ever waits on the other.
+ */
+class ZoneBuffer
+{
+ public:
+  static constexpr size_t CAPACITY = 4096;
+
+  explicit ZoneBuffer(unsigned int thread_id) noexcept;
+
+  void push(const char* name, std::int64_t start, std::int64_t end) noexcept;
+
+  /**
+   *  Appends the samples still held, oldest first.
+   *  @param [out] samples Where the samples are appended
+   */
+  void snapshot(std::vector<ZoneSample>& samples) const;
+
+ private:
+  struct Slot
+  {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<std::int64_t> start{ 0 };
+    std::atomic<std::int64_t> end{ 0 };
+  };
+
+  std::array<Slot, CAPACITY> slots;
+  std::atomic<std::uint64_t> head{ 0 };
+  unsigned int thread;
+};
+
+/**
+ *  Collects timing zones from every thread.
+ *  Each thread records into its own ZoneBuffer, taken the first time
+ *  the thread completes a zone and handed back when the thread exits,
+ *  for the next new thread to reuse. The zones can be summarised for
+ *  the in-game overlay or exported as a Chrome trace, which opens in
+ *  chrome://tracing or Perfetto.
+ *  @see ScopedZone
+ */
+class Profiler
+{
+ public:
+  static Profiler& getInstance();
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  /**
+   *  The profiler's clock.
+   *  @return nanoseconds since the profiler started
+   */
+  static std::int64_t now() noexcept;
+
+  void record(const char* name, std::int64_t start, std::int64_t end) noexcept;
+
+  /**
+   *  Sums the zones that ended within a window, by name.
+   *  @param [in] since Zones that ended before this time are skipped
+   *  @param [out] stats One entry per zone name, in first seen order
+   */
+  void summarise(std::int64_t since, std::vector<ZoneStats>& stats) const;
+
+  /**
+   *  Writes every zone still held as Chrome trace event json.
+   *  @param [in] file_name The file to write
+   *  @return true if the file was written
+   */
+  bool exportTrace(const std::string& file_name) const;
+
+ private:
+  Profiler() = default;
+  ~Profiler() = default;
+
+  class ThreadRing;
+
+  ZoneBuffer& threadBuffer();
+  void release(ZoneBuffer& buffer);
+  std::vector<ZoneSample> samples() const;
+
+  mutable std::mutex buffers_mutex;
+  std::vector<std::unique_ptr<ZoneBuffer>> buffers;
+  std::vector<ZoneBuffer*> free_buffers; /**< Rings of exited threads. */
+};
+
+/**
+ *  Times the scope it is declared in, e.g. ScopedZone zone("update");
+ *  Names must be string literals, only the pointer is kept.
+ */
+class ScopedZone
+{
+ public:
+  explicit ScopedZone(const char* zone_name) noexcept :
+    name(zone_name), start(Profiler::now())
+  {
+  }
+
+  ~ScopedZone()
+  {
+    Profiler::getInstance().record(name, start, Profiler::now());
+  }
+
+  ScopedZone(const ScopedZone&) = delete;
+  ScopedZone& operator=(const ScopedZone&) = delete;
+
+ private:
+  const char* name;
+  std::int64_t start;
+};
@@ -0,0 +1,106 @@
+#include "FramePacket.h"
+#include <cstring>
+
+constexpr size_t TextDraw::LENGTH;
+
+namespace
+{
+  std::uint32_t channel(float value) noexcept
+  {
+    const float clamped = value < 0 ? 0 : (value > 1 ? 1 : value);
+    return static_cast<std::uint32_t>(clamped * 255.0F + 0.5F);
+  }
+
+  SpriteDraw makeDraw(std::uint16_t sprite,
+                      float x,
+                      float y,
+                      std::int16_t z,
+                      bool visible,
+                      PackedColour colour) noexcept
+  {
+    SpriteDraw draw;
+    draw.x = x;
+    draw.y = y;
+    draw.colour = colour;
+    draw.sprite = sprite;
+    draw.z = z;
+    draw.visible = visible;
+    return draw;
+  }
+}
+
+PackedColour packColour(const float rgb[3]) noexcept
+{
+  return channel(rgb[0]) << 16U | channel(rgb[1]) << 8U | channel(rgb[2]);
+}
+
+ASGE::Colour unpackColour(PackedColour colour) noexcept
+{
+  const float rgb[3] = { static_cast<float>(colour >> 16U & 0xFFU) / 255.0F,
+                         static_cast<float>(colour >> 8U & 0xFFU) / 255.0F,
+                         static_cast<float>(colour & 0xFFU) / 255.0F };
+  return ASGE::Colour(rgb);
+}
+
+void FramePacket::clear() noexcept
+{
+  sprites.clear();
+  texts.clear();
+  traces.clear();
+}
+
+void FramePacket::reserve(size_t sprite_count, size_t text_count)
+{
+  sprites.reserve(sprite_count);
+  static_sprites.reserve(sprite_count);
+  texts.reserve(text_count);
+}
+
+void FramePacket::clearStatic(unsigned long long version) noexcept
+{
+  static_sprites.clear();
+  static_version = version;
+}
+
+void FramePacket::addSprite(std::uint16_t sprite,
+                            float x,
+                            float y,
+                            std::int16_t z,
+                            bool visible,
+                            PackedColour colour)
+{
+  sprites.push_back(makeDraw(sprite, x, y, z, visible, colour));
+}
+
+void FramePacket::addStaticSprite(std::uint16_t sprite,
+                                  float x,
+                                  float y,
+                                  std::int16_t z,
+                                  bool visible,
+                                  PackedColour colour)
+{
+  static_sprites.push_back(makeDraw(sprite, x, y, z, visible, colour));
+}
+
+void FramePacket::addStaticSprite(const SpriteDraw& draw)
+{
+  static_sprites.push_back(draw);
+}
+
+/**
+ *   @brief   Queues a line of text
+ *   @details The text is copied into the draw, so the caller may format
+ *            it in a temporary buffer.
+ *   @return  void
+ */
+void FramePacket::addText(
+  const char* text, float x, float y, float scale, PackedColour colour)
+{
+  texts.emplace_back();
+  TextDraw& draw = texts.back();
+  std::strncpy(draw.text, text, TextDraw::LENGTH - 1);
+  draw.x = x;
+  draw.y = y;
+  draw.scale = scale;
+  draw.colour = colour;
+}
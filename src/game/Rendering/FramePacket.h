@@ -0,0 +1,127 @@
+#pragma once
+#include <Engine/Colours.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ *  A colour packed into 0xRRGGBB, so draws stay small.
+ */
+using PackedColour = std::uint32_t;
+
+/**
+ *  Packs one of the ASGE::COLOURS.
+ *  @param [in] rgb The red, green and blue components, 0 to 1
+ *  @return the packed colour
+ */
+PackedColour packColour(const float rgb[3]) noexcept;
+
+/**
+ *  @param [in] colour The packed colour
+ *  @return the colour, ready to hand to the renderer
+ */
+ASGE::Colour unpackColour(PackedColour colour) noexcept;
+
+/**
+ *  A sprite to draw, by its id in the SpriteTable.
+ *  @see SpriteTable
+ */
+struct SpriteDraw
+{
+  float x = 0;
+  float y = 0;
+  float width = 0; /**< Zero draws the sprite at its own size. */
+  float height = 0;
+  PackedColour colour = 0xFFFFFF;
+  std::uint16_t sprite = 0;
+  std::int16_t z = 0;
+  bool visible = true;
+};
+
+/**
+ *  A line of text to draw. Text longer than the buffer is cut short.
+ *  ASGE takes the text as a std::string by value, so lines are kept
+ *  within the small string buffer of the standard libraries the game
+ *  builds with, which then never allocates.
+ */
+struct TextDraw
+{
+  static constexpr size_t LENGTH = 16;
+
+  char text[LENGTH] = {};
+  float x = 0;
+  float y = 0;
+  float scale = 1;
+  PackedColour colour = 0xFFFFFF;
+};
+
+/**
+ *  An input whose effect a frame is the first to show, carried through
+ *  to render by the latency tracer. Times are on the profiler clock.
+ *  @see LatencyTracer
+ */
+struct InputTrace
+{
+  unsigned long long id = 0;
+  std::int64_t key_time = 0;   /**< When the key callback queued it. */
+  std::int64_t apply_time = 0; /**< When a tick boundary applied it. */
+  std::int64_t write_time = 0; /**< When the frame showing it was written. */
+};
+
+/**
+ *  Everything drawn in a frame, copied out of the simulation.
+ *  The simulation writes a packet once it has run the frame's ticks and
+ *  the render thread draws it, so neither reads the other's live state.
+ *  Packets are reused frame to frame, so once their buffers have grown
+ *  to fit a frame writing them never allocates.
+ *
+ *  Sprites that rarely change, such as the barriers, go in the static
+ *  layer. It is stamped with a version and survives clear, so it is only
+ *  rewritten into a packet, and only re-sorted by the renderer, when the
+ *  simulation changes it.
+ *  @see TripleBuffer
+ */
+struct FramePacket
+{
+  unsigned long long frame = 0; /**< Zero until the first frame is written. */
+  std::vector<SpriteDraw> sprites;
+  std::vector<TextDraw> texts;
+
+  unsigned long long static_version = 0; /**< Zero until first written. */
+  std::vector<SpriteDraw> static_sprites;
+
+  std::vector<InputTrace> traces; /**< Only written while tracing. */
+
+  /**
+   *  Empties the packet, apart from the static layer.
+   */
+  void clear() noexcept;
+  void reserve(size_t sprite_count, size_t text_count);
+
+  /**
+   *  Empties the static layer, ready to write the given version of it.
+   *  @param [in] version The version being written
+   */
+  void clearStatic(unsigned long long version) noexcept;
+
+  void addSprite(std::uint16_t sprite,
+                 float x,
+                 float y,
+                 std::int16_t z,
+                 bool visible = true,
+                 PackedColour colour = 0xFFFFFF);
+
+  void addStaticSprite(std::uint16_t sprite,
+                       float x,
+                       float y,
+                       std::int16_t z,
+                       bool visible = true,
+                       PackedColour colour = 0xFFFFFF);
+  void addStaticSprite(const SpriteDraw& draw);
+
+  void addText(const char* text,
+               float x,
+               float y,
+               float scale = 1,
+               PackedColour colour = 0xFFFFFF);
+};
@@ -0,0 +1,183 @@
+#include "FrameRenderer.h"
+#include "Resources/TextureCache.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+  const std::uint64_t INDEX_MASK = 0xFFFFFFFF;
+  const unsigned int KEY_SHIFT = 32;
+  const unsigned int Z_SHIFT = 16;
+  const std::uint64_t RANK_MASK = 0xFFFF;
+}
+
+int FrameRenderer::addSprite(ASGE::Renderer* renderer,
+                             const std::string& texture_file_name)
+{
+  if (sprites.size() > std::numeric_limits<std::uint16_t>::max())
+  {
+    return -1;
+  }
+
+  auto sprite = TextureCache::getInstance().load(renderer, texture_file_name);
+  if (sprite == nullptr)
+  {
+    return -1;
+  }
+
+  // ids drawn from the same texture, such as one atlas page, share a rank
+  const ASGE::Texture2D* texture = sprite->getTexture();
+  auto rank = static_cast<std::uint16_t>(
+    texture_ranks.empty()
+      ? 0
+      : *std::max_element(texture_ranks.begin(), texture_ranks.end()) + 1);
+  for (size_t id = 0; id < sprites.size() && texture != nullptr; ++id)
+  {
+    if (sprites[id]->getTexture() == texture)
+    {
+      rank = texture_ranks[id];
+      break;
+    }
+  }
+
+  widths.push_back(sprite->width());
+  heights.push_back(sprite->height());
+  sprites.push_back(std::move(sprite));
+  texture_ranks.push_back(rank);
+  return static_cast<int>(sprites.size() - 1);
+}
+
+/**
+ *   @brief   Draws a frame
+ *   @details The packet's sprites and its static layer are each sorted
+ *            by z and texture, and merged as they are drawn. The static
+ *            layer is only sorted when its version changes; every packet
+ *            with the same version holds the same static sprites, so the
+ *            order applies to whichever buffer is being drawn. Draws
+ *            with unknown sprite ids are skipped, a packet written
+ *            before its textures were registered simply draws less.
+ *            Each line of text reuses the string it was drawn from last
+ *            frame, which is only rewritten when the line has changed.
+ *   @return  void
+ */
+void FrameRenderer::render(ASGE::Renderer* renderer, const FramePacket& packet)
+{
+  if (packet.static_version != static_version)
+  {
+    sortDraws(packet.static_sprites, static_order);
+    static_version = packet.static_version;
+  }
+  sortDraws(packet.sprites, dynamic_order);
+
+  last_batches = 0;
+  std::uint64_t last_rank = RANK_MASK + 1;
+  size_t next_static = 0;
+  size_t next_dynamic = 0;
+  while (next_static < static_order.size() ||
+         next_dynamic < dynamic_order.size())
+  {
+    // on equal keys the static layer goes first, it is further back
+    const bool from_static =
+      next_dynamic == dynamic_order.size() ||
+      (next_static < static_order.size() &&
+       static_order[next_static] >> KEY_SHIFT <=
+         dynamic_order[next_dynamic] >> KEY_SHIFT);
+
+    const std::uint64_t entry = from_static ? static_order[next_static++]
+                                            : dynamic_order[next_dynamic++];
+    const SpriteDraw& draw = from_static
+                               ? packet.static_sprites[entry & INDEX_MASK]
+                               : packet.sprites[entry & INDEX_MASK];
+
+    const std::uint64_t rank = entry >> KEY_SHIFT & RANK_MASK;
+    if (rank != last_rank)
+    {
+      ++last_batches;
+      last_rank = rank;
+    }
+
+    ASGE::Sprite& sprite = *sprites[draw.sprite];
+    sprite.xPos(draw.x);
+    sprite.yPos(draw.y);
+    sprite.width(draw.width > 0 ? draw.width : widths[draw.sprite]);
+    sprite.height(draw.height > 0 ? draw.height : heights[draw.sprite]);
+    sprite.colour(unpackColour(draw.colour));
+    renderer->renderSprite(sprite, static_cast<float>(draw.z));
+  }
+
+  if (texts.size() < packet.texts.size())
+  {
+    texts.resize(packet.texts.size());
+  }
+
+  for (size_t line = 0; line < packet.texts.size(); ++line)
+  {
+    const TextDraw& draw = packet.texts[line];
+    if (texts[line].compare(draw.text) != 0)
+    {
+      texts[line].assign(draw.text);
+    }
+
+    renderer->renderText(texts[line],
+                         static_cast<int>(draw.x),
+                         static_cast<int>(draw.y),
+                         draw.scale,
+                         unpackColour(draw.colour));
+  }
+}
+
+void FrameRenderer::reserve(size_t sprite_count, size_t text_count)
+{
+  dynamic_order.reserve(sprite_count);
+  static_order.reserve(sprite_count);
+  if (texts.size() < text_count)
+  {
+    texts.resize(text_count);
+  }
+}
+
+size_t FrameRenderer::size() const noexcept
+{
+  return sprites.size();
+}
+
+size_t FrameRenderer::batches() const noexcept
+{
+  return last_batches;
+}
+
+/**
+ *   @brief   Sorts the visible draws in a list
+ *   @details Each draw's key is packed above its index, so sorting the
+ *            packed values orders draws by key and keeps draws with equal
+ *            keys in the order they were added, without the allocation
+ *            of a stable sort.
+ *   @return  void
+ */
+void FrameRenderer::sortDraws(const std::vector<SpriteDraw>& draws,
+                              std::vector<std::uint64_t>& order) const
+{
+  order.clear();
+  for (size_t index = 0; index < draws.size(); ++index)
+  {
+    const SpriteDraw& draw = draws[index];
+    if (draw.visible && draw.sprite < sprites.size())
+    {
+      order.push_back(drawKey(draw) << KEY_SHIFT | index);
+    }
+  }
+
+  std::sort(order.begin(), order.end());
+}
+
+/**
+ *   @brief   The key a draw is sorted by
+ *   @return  the draw's z, offset so it sorts unsigned, above its rank
+ */
+std::uint64_t FrameRenderer::drawKey(const SpriteDraw& draw) const noexcept
+{
+  const auto z =
+    static_cast<std::uint16_t>(static_cast<std::int32_t>(draw.z) -
+                               std::numeric_limits<std::int16_t>::min());
+  return static_cast<std::uint64_t>(z) << Z_SHIFT | texture_ranks[draw.sprite];
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "FramePacket.h"
+#include <Engine/Renderer.h>
+#include <Engine/Sprite.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ *  Draws frame packets on the thread that owns the renderer.
+ *  Packets refer to sprites by id rather than holding them, so the
+ *  simulation never touches a sprite the renderer may be drawing. Each
+ *  id names a texture registered here, whose shared sprite is moved to
+ *  every draw's position in turn as the packet is drawn.
+ *
+ *  Sprites are drawn sorted by z and then by texture, with ids that share
+ *  a texture, such as images packed in one atlas page, counting as one.
+ *  Drawn in deferred mode, consecutive sprites with the same texture go
+ *  to the GPU together, so the number of batches depends on the textures
+ *  in use rather than on how many entities there are. The packet's static
+ *  layer is sorted once per version and kept here between frames, as is
+ *  the string handed to the renderer for each line of text.
+ *  @see FramePacket
+ */
+class FrameRenderer
+{
+ public:
+  FrameRenderer() = default;
+  ~FrameRenderer() = default;
+
+  FrameRenderer(const FrameRenderer&) = delete;
+  FrameRenderer& operator=(const FrameRenderer&) = delete;
+
+  /**
+   *  Registers a texture for packets to draw.
+   *  @param [in] renderer The renderer used to perform the allocations
+   *  @param [in] texture_file_name The file path to the the texture to load
+   *  @return the texture's sprite id, or -1 if it failed to load
+   */
+  int addSprite(ASGE::Renderer* renderer,
+                const std::string& texture_file_name);
+
+  /**
+   *  Draws the visible sprites in the packet and its static layer, sorted
+   *  by z and texture, then its text. Sprites with the same z and texture
+   *  are drawn in the order they were added.
+   *  @param [in] renderer The renderer to draw with
+   *  @param [in] packet The frame to draw
+   */
+  void render(ASGE::Renderer* renderer, const FramePacket& packet);
+
+  /**
+   *  Makes room to draw a frame without allocating.
+   *  @param [in] sprite_count The most sprites a frame is expected to hold
+   *  @param [in] text_count The most lines of text a frame is expected to
+   *              hold
+   */
+  void reserve(size_t sprite_count, size_t text_count);
+
+  size_t size() const noexcept;
+
+  /**
+   *  The number of texture batches the last frame drew.
+   */
+  size_t batches() const noexcept;
+
+ private:
+  void sortDraws(const std::vector<SpriteDraw>& draws,
+                 std::vector<std::uint64_t>& order) const;
+  std::uint64_t drawKey(const SpriteDraw& draw) const noexcept;
+
+  std::vector<std::shared_ptr<ASGE::Sprite>> sprites;
+  std::vector<std::uint16_t> texture_ranks; /**< Shared by each texture. */
+  std::vector<float> widths;  /**< Each sprite's own size. */
+  std::vector<float> heights;
+
+  // visible draws, as their sort key and index into the draw list
+  std::vector<std::uint64_t> dynamic_order;
+  std::vector<std::uint64_t> static_order;
+  unsigned long long static_version = 0;
+
+  // the string for each line of text, only rebuilt when the text changes
+  std::vector<std::string> texts;
+
+  size_t last_batches = 0;
+};
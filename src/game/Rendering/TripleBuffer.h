@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/**
+ *  Hands the latest of a series of values from one writer thread to
+ *  one reader thread without either waiting on the other.
+ *  Of the three buffers the writer owns one, the reader owns one and the
+ *  third holds the last value published. Publishing swaps the writer's
+ *  buffer with the held one and reading swaps the reader's with it if
+ *  it is newer, so the writer never overwrites what is being read and
+ *  the reader skips straight to the newest value when it falls behind.
+ */
+template <typename T>
+class TripleBuffer
+{
+ public:
+  TripleBuffer() = default;
+  ~TripleBuffer() = default;
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /**
+   *  The buffer to write the next value into. Writer thread only.
+   *  @return the writer's buffer, holding whatever it last held
+   */
+  T& write() noexcept { return buffers[back]; }
+
+  /**
+   *  Makes the written buffer the latest value. Writer thread only.
+   */
+  void publish() noexcept
+  {
+    const std::uint8_t previous =
+      held.exchange(static_cast<std::uint8_t>(back | FRESH),
+                    std::memory_order_acq_rel);
+    back = static_cast<std::uint8_t>(previous & INDEX);
+  }
+
+  /**
+   *  Takes the latest published value, if there is a new one. Reader
+   *  thread only.
+   *  @return the reader's buffer, default constructed until the first
+   *          value is published
+   */
+  const T& read() noexcept
+  {
+    if ((held.load(std::memory_order_relaxed) & FRESH) != 0)
+    {
+      const std::uint8_t previous =
+        held.exchange(front, std::memory_order_acq_rel);
+      front = static_cast<std::uint8_t>(previous & INDEX);
+    }
+
+    return buffers[front];
+  }
+
+  /**
+   *  Calls a function on every buffer, for sizing them up front. Only
+   *  safe while neither thread is using the buffers.
+   *  @param [in] function Called as function(T&) for each buffer
+   */
+  template <typename Function>
+  void forEach(Function function)
+  {
+    for (auto& buffer : buffers)
+    {
+      function(buffer);
+    }
+  }
+
+ private:
+  static constexpr std::uint8_t INDEX = 0x3;
+  static constexpr std::uint8_t FRESH = 0x4;
+
+  T buffers[3];
+  std::uint8_t back = 0;
+  std::uint8_t front = 1;
+  std::atomic<std::uint8_t> held{ 2 };
+};
@@ -0,0 +1,203 @@
+#include "InputRecording.h"
+#include <Engine/FileIO.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+  const char MAGIC[4] = { 'S', 'I', 'R', 'P' };
+  const std::uint8_t VERSION = 1;
+
+  void writeVarint(std::vector<std::uint8_t>& out, std::uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      out.push_back(static_cast<std::uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+  }
+
+  bool readVarint(const std::vector<std::uint8_t>& in,
+                  size_t& pos,
+                  std::uint64_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64 && pos < in.size(); shift += 7)
+    {
+      const std::uint8_t byte = in[pos++];
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // zigzag, so the -1 the engine uses for unset fields stays one byte
+  void writeInt(std::vector<std::uint8_t>& out, int value)
+  {
+    const auto wide = static_cast<std::int64_t>(value);
+    writeVarint(out,
+                (static_cast<std::uint64_t>(wide) << 1) ^
+                  static_cast<std::uint64_t>(wide >> 63));
+  }
+
+  bool readInt(const std::vector<std::uint8_t>& in, size_t& pos, int& value)
+  {
+    std::uint64_t raw = 0;
+    if (!readVarint(in, pos, raw))
+    {
+      return false;
+    }
+    value = static_cast<int>(static_cast<std::int64_t>(raw >> 1) ^
+                             -static_cast<std::int64_t>(raw & 1));
+    return true;
+  }
+}
+
+void InputRecording::record(unsigned long long tick,
+                            const ASGE::KeyEvent& event)
+{
+  RecordedKey recorded;
+  recorded.tick = tick;
+  recorded.key = event.key;
+  recorded.action = event.action;
+  recorded.mods = event.mods;
+  events.push_back(recorded);
+}
+
+void InputRecording::length(unsigned long long tick_count) noexcept
+{
+  ticks = tick_count;
+}
+
+unsigned long long InputRecording::length() const noexcept
+{
+  return ticks;
+}
+
+/**
+ *   @brief   Writes the recording to disk.
+ *   @details Saved through the standard library rather than the
+ *            engine's file system, as recordings live wherever the
+ *            user asks rather than in the game's data folder.
+ *   @return  True if the file was written.
+ */
+bool InputRecording::save(const std::string& file_name) const
+{
+  std::vector<std::uint8_t> bytes(std::begin(MAGIC), std::end(MAGIC));
+  bytes.push_back(VERSION);
+  writeVarint(bytes, ticks);
+  writeVarint(bytes, events.size());
+
+  unsigned long long last_tick = 0;
+  for (const auto& event : events)
+  {
+    writeVarint(bytes, event.tick - last_tick);
+    writeInt(bytes, event.key);
+    writeInt(bytes, event.action);
+    writeInt(bytes, event.mods);
+    last_tick = event.tick;
+  }
+
+  std::ofstream file(file_name, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(bytes.data()),
+             static_cast<std::streamsize>(bytes.size()));
+  return file.good();
+}
+
+/**
+ *   @brief   Reads a recording.
+ *   @details The file is looked for on disk first, then in the game's
+ *            mounted data folder, so sessions shipped with the game can
+ *            be loaded as /data/replays/...
+ *   @return  True if the recording was loaded.
+ */
+bool InputRecording::load(const std::string& file_name)
+{
+  std::vector<std::uint8_t> bytes;
+
+  std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+  if (file)
+  {
+    bytes.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+  }
+  else
+  {
+    ASGE::FILEIO::File data_file;
+    if (!data_file.open(file_name))
+    {
+      return false;
+    }
+
+    auto buffer = data_file.read();
+    bytes.assign(buffer.as_unsigned_char(),
+                 buffer.as_unsigned_char() + buffer.length);
+  }
+
+  if (bytes.size() < sizeof(MAGIC) + 1 ||
+      !std::equal(std::begin(MAGIC), std::end(MAGIC), bytes.begin()) ||
+      bytes[sizeof(MAGIC)] != VERSION)
+  {
+    return false;
+  }
+
+  size_t pos = sizeof(MAGIC) + 1;
+  std::uint64_t tick_count = 0;
+  std::uint64_t event_count = 0;
+  if (!readVarint(bytes, pos, tick_count) ||
+      !readVarint(bytes, pos, event_count) || event_count > bytes.size())
+  {
+    return false;
+  }
+
+  std::vector<RecordedKey> loaded(event_count);
+  unsigned long long tick = 0;
+  for (auto& event : loaded)
+  {
+    std::uint64_t gap = 0;
+    if (!readVarint(bytes, pos, gap) || !readInt(bytes, pos, event.key) ||
+        !readInt(bytes, pos, event.action) || !readInt(bytes, pos, event.mods))
+    {
+      return false;
+    }
+
+    tick += gap;
+    event.tick = tick;
+  }
+
+  events = std::move(loaded);
+  ticks = tick_count;
+  cursor = 0;
+  return true;
+}
+
+const RecordedKey* InputRecording::next(unsigned long long tick) noexcept
+{
+  if (cursor == events.size() || events[cursor].tick > tick)
+  {
+    return nullptr;
+  }
+  return &events[cursor++];
+}
+
+void InputRecording::rewind() noexcept
+{
+  cursor = 0;
+}
+
+bool InputRecording::finished() const noexcept
+{
+  return cursor == events.size();
+}
+
+size_t InputRecording::size() const noexcept
+{
+  return events.size();
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <Engine/InputEvents.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ *  A key event, stamped with the simulation tick it arrived before.
+ */
+struct RecordedKey
+{
+  unsigned long long tick = 0;
+  int key = -1;
+  int action = -1;
+  int mods = -1;
+};
+
+/**
+ *  The key events of a play session, in the order the game saw them.
+ *  As the simulation runs in fixed ticks, feeding the events back
+ *  before the tick they were recorded at replays the session exactly.
+ *  Files hold a small header followed by each event as varints, with
+ *  ticks stored as the gap since the previous event, so a session costs
+ *  a few bytes per key press.
+ */
+class InputRecording
+{
+ public:
+  /**
+   *  Appends a key event.
+   *  @param [in] tick The number of ticks simulated before the event
+   *  @param [in] event The key event
+   */
+  void record(unsigned long long tick, const ASGE::KeyEvent& event);
+
+  /**
+   *  Sets the number of ticks the session ran for.
+   *  @param [in] tick_count The tick count when the recording ended
+   */
+  void length(unsigned long long tick_count) noexcept;
+  unsigned long long length() const noexcept;
+
+  bool save(const std::string& file_name) const;
+  bool load(const std::string& file_name);
+
+  /**
+   *  Takes the next event due at or before the tick.
+   *  @param [in] tick The tick about to be simulated
+   *  @return the event, or nullptr if none are due
+   */
+  const RecordedKey* next(unsigned long long tick) noexcept;
+
+  /**
+   *  Starts playback from the first event again.
+   */
+  void rewind() noexcept;
+
+  bool finished() const noexcept;
+  size_t size() const noexcept;
+
+ private:
+  std::vector<RecordedKey> events;
+  unsigned long long ticks = 0;
+  size_t cursor = 0;
+};
@@ -0,0 +1,139 @@
+#include "Snapshot.h"
+#include <algorithm>
+
+namespace
+{
+  // a literal run only ends at a run of zeros long enough to pay for the
+  // two lengths that start the next one
+  const size_t MIN_ZERO_RUN = 4;
+
+  void writeVarint(std::vector<std::uint8_t>& delta, size_t length)
+  {
+    while (length >= 0x80)
+    {
+      delta.push_back(static_cast<std::uint8_t>(length | 0x80));
+      length >>= 7;
+    }
+    delta.push_back(static_cast<std::uint8_t>(length));
+  }
+
+  bool readVarint(const std::uint8_t* delta,
+                  size_t length,
+                  size_t& pos,
+                  size_t& value) noexcept
+  {
+    value = 0;
+    for (unsigned shift = 0; pos < length && shift < 64; shift += 7)
+    {
+      const std::uint8_t byte = delta[pos++];
+      value |= static_cast<size_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::uint8_t byteAt(const std::vector<std::uint8_t>& snapshot,
+                      size_t index) noexcept
+  {
+    return index < snapshot.size() ? snapshot[index] : std::uint8_t{ 0 };
+  }
+}
+
+/**
+ *   @brief   Encodes a snapshot against the one before
+ *   @details The delta is the length of the snapshot, then pairs of a
+ *            count of unchanged bytes and a run of changed bytes, XORed
+ *            with the bytes they replace. Lengths are written seven bits
+ *            to a byte, so short runs cost one byte each. Where the
+ *            snapshots differ in length, the shorter one reads as zeros.
+ */
+void encodeDelta(const std::vector<std::uint8_t>& previous,
+                 const std::vector<std::uint8_t>& current,
+                 std::vector<std::uint8_t>& delta)
+{
+  delta.clear();
+  writeVarint(delta, current.size());
+
+  const size_t size = current.size();
+  size_t pos = 0;
+  while (pos < size)
+  {
+    const size_t zeros_start = pos;
+    while (pos < size && current[pos] == byteAt(previous, pos))
+    {
+      ++pos;
+    }
+    if (pos == size)
+    {
+      break;
+    }
+
+    // extend the literal until a run of zeros worth splitting at
+    const size_t literal_start = pos;
+    size_t literal_end = pos;
+    size_t zeros = 0;
+    while (pos < size && zeros < MIN_ZERO_RUN)
+    {
+      if (current[pos] == byteAt(previous, pos))
+      {
+        ++zeros;
+      }
+      else
+      {
+        zeros = 0;
+        literal_end = pos + 1;
+      }
+      ++pos;
+    }
+    pos = literal_end;
+
+    writeVarint(delta, literal_start - zeros_start);
+    writeVarint(delta, literal_end - literal_start);
+    for (size_t i = literal_start; i < literal_end; ++i)
+    {
+      delta.push_back(
+        static_cast<std::uint8_t>(current[i] ^ byteAt(previous, i)));
+    }
+  }
+}
+
+bool decodeDelta(const std::vector<std::uint8_t>& previous,
+                 const std::uint8_t* delta,
+                 size_t length,
+                 std::vector<std::uint8_t>& current)
+{
+  size_t pos = 0;
+  size_t size = 0;
+  if (!readVarint(delta, length, pos, size))
+  {
+    return false;
+  }
+
+  const auto kept =
+    static_cast<std::ptrdiff_t>(std::min(size, previous.size()));
+  current.assign(previous.begin(), previous.begin() + kept);
+  current.resize(size, 0);
+
+  size_t at = 0;
+  while (pos < length)
+  {
+    size_t zeros = 0;
+    size_t literal = 0;
+    if (!readVarint(delta, length, pos, zeros) ||
+        !readVarint(delta, length, pos, literal) || zeros > size - at ||
+        literal > size - at - zeros || literal > length - pos)
+    {
+      return false;
+    }
+
+    at += zeros;
+    for (size_t i = 0; i < literal; ++i, ++at, ++pos)
+    {
+      current[at] = static_cast<std::uint8_t>(current[at] ^ delta[pos]);
+    }
+  }
+  return true;
+}
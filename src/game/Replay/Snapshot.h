@@ -0,0 +1,151 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+ *  Appends plain values to a flat snapshot buffer.
+ *  Values are copied in the machine's own layout, as snapshots are only
+ *  read back by the build of the game that wrote them. Arrays are
+ *  prefixed with their length.
+ *  @see SnapshotReader
+ */
+class SnapshotWriter
+{
+ public:
+  explicit SnapshotWriter(std::vector<std::uint8_t>& buffer) noexcept :
+    bytes(buffer)
+  {
+  }
+
+  template <typename T> void write(const T& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "snapshots hold plain values");
+    const auto* first = reinterpret_cast<const std::uint8_t*>(&value);
+    bytes.insert(bytes.end(), first, first + sizeof(T));
+  }
+
+  template <typename T> void writeArray(const T* values, size_t count)
+  {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "snapshots hold plain values");
+    write(static_cast<std::uint32_t>(count));
+    const auto* first = reinterpret_cast<const std::uint8_t*>(values);
+    bytes.insert(bytes.end(), first, first + count * sizeof(T));
+  }
+
+ private:
+  std::vector<std::uint8_t>& bytes;
+};
+
+/**
+ *  Reads values back out of a snapshot buffer, in the order they were
+ *  written. Every read is bounds checked, and fails rather than reading
+ *  past the end.
+ *  @see SnapshotWriter
+ */
+class SnapshotReader
+{
+ public:
+  SnapshotReader(const std::uint8_t* buffer, size_t length) noexcept :
+    bytes(buffer), size(length)
+  {
+  }
+
+  template <typename T> bool read(T& value) noexcept
+  {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "snapshots hold plain values");
+    if (size - pos < sizeof(T))
+    {
+      return false;
+    }
+
+    std::memcpy(&value, bytes + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  /**
+   *  Reads an array that must be of a known length.
+   *  @param [out] values Where the array is copied to
+   *  @param [in] count The length the array must have
+   *  @return false if the array was of another length
+   */
+  template <typename T> bool readArray(T* values, size_t count) noexcept
+  {
+    std::uint32_t length = 0;
+    if (!read(length) || length != count ||
+        (size - pos) / sizeof(T) < count)
+    {
+      return false;
+    }
+
+    std::memcpy(values, bytes + pos, count * sizeof(T));
+    pos += count * sizeof(T);
+    return true;
+  }
+
+  /**
+   *  Reads an array of any length up to a limit, resizing the vector to
+   *  hold it.
+   *  @param [out] values Where the array is copied to
+   *  @param [in] limit The longest the array may be
+   *  @return false if the array was longer than the limit
+   */
+  template <typename T>
+  bool readArray(std::vector<T>& values, size_t limit)
+  {
+    std::uint32_t length = 0;
+    if (!read(length) || length > limit || (size - pos) / sizeof(T) < length)
+    {
+      return false;
+    }
+
+    values.resize(length);
+    std::memcpy(values.data(), bytes + pos, length * sizeof(T));
+    pos += length * sizeof(T);
+    return true;
+  }
+
+  /**
+   *  @return true once every byte has been read
+   */
+  bool done() const noexcept { return pos == size; }
+
+ private:
+  const std::uint8_t* bytes;
+  size_t size;
+  size_t pos = 0;
+};
+
+/**
+ *  Encodes a snapshot as its difference from the one before.
+ *  The two are XORed, so everything that did not change becomes zero,
+ *  and the result is run length encoded as alternating runs of zeros
+ *  and of literal bytes. Consecutive snapshots of a game differ in few
+ *  bytes, so a delta is a small fraction of the snapshot.
+ *  @param [in] previous The snapshot before, empty for the first
+ *  @param [in] current The snapshot to encode
+ *  @param [out] delta The encoded difference, replaced
+ */
+void encodeDelta(const std::vector<std::uint8_t>& previous,
+                 const std::vector<std::uint8_t>& current,
+                 std::vector<std::uint8_t>& delta);
+
+/**
+ *  Rebuilds a snapshot from the one before and the delta encoded
+ *  between them.
+ *  @param [in] previous The snapshot the delta was encoded against
+ *  @param [in] delta The bytes written by encodeDelta
+ *  @param [in] length The length of the delta
+ *  @param [out] current The snapshot, replaced
+ *  @return false if the delta is malformed
+ */
+bool decodeDelta(const std::vector<std::uint8_t>& previous,
+                 const std::uint8_t* delta,
+                 size_t length,
+                 std::vector<std::uint8_t>& current);
@@ -0,0 +1,88 @@
+#include "StateHistory.h"
+#include "Snapshot.h"
+#include <chrono>
+
+void StateHistory::reserve(size_t snapshots)
+{
+  offsets.reserve(snapshots + 1);
+}
+
+/**
+ *   @brief   Appends a snapshot
+ *   @details The delta is encoded into scratch and then appended, and the
+ *            snapshot kept to encode the next against. Both buffers keep
+ *            their memory, so once they have grown to the size of a
+ *            snapshot pushing only allocates when the history does.
+ *   @return  void
+ */
+void StateHistory::push(const std::vector<std::uint8_t>& snapshot)
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  encodeDelta(last, snapshot, delta);
+  if (offsets.empty())
+  {
+    offsets.push_back(0);
+  }
+  deltas.insert(deltas.end(), delta.begin(), delta.end());
+  offsets.push_back(deltas.size());
+  last.assign(snapshot.begin(), snapshot.end());
+
+  raw_bytes += snapshot.size();
+  encode_seconds += std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+}
+
+bool StateHistory::restore(size_t index,
+                           std::vector<std::uint8_t>& snapshot) const
+{
+  if (index >= size())
+  {
+    return false;
+  }
+
+  std::vector<std::uint8_t> previous;
+  snapshot.clear();
+  for (size_t i = 0; i <= index; ++i)
+  {
+    previous.swap(snapshot);
+    if (!decodeDelta(previous,
+                     deltas.data() + offsets[i],
+                     offsets[i + 1] - offsets[i],
+                     snapshot))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void StateHistory::clear() noexcept
+{
+  deltas.clear();
+  offsets.clear();
+  last.clear();
+  raw_bytes = 0;
+  encode_seconds = 0;
+}
+
+size_t StateHistory::size() const noexcept
+{
+  return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+size_t StateHistory::rawBytes() const noexcept
+{
+  return raw_bytes;
+}
+
+size_t StateHistory::encodedBytes() const noexcept
+{
+  return deltas.size();
+}
+
+double StateHistory::encodeSeconds() const noexcept
+{
+  return encode_seconds;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ *  Every snapshot of a session, kept as deltas.
+ *  Each snapshot is stored as its delta from the one before, so keeping
+ *  a state per tick costs little more than the bytes that changed in
+ *  it. Getting a snapshot back replays the deltas from the first, so
+ *  restoring is linear in how far into the history the snapshot is.
+ *  @see encodeDelta
+ */
+class StateHistory
+{
+ public:
+  /**
+   *  Reserves room for the snapshots' offsets up front. The deltas grow
+   *  as needed, as their size depends on how much each tick changes.
+   *  @param [in] snapshots The number of snapshots expected
+   */
+  void reserve(size_t snapshots);
+
+  /**
+   *  Appends a snapshot, encoded against the last one pushed.
+   *  @param [in] snapshot The snapshot
+   */
+  void push(const std::vector<std::uint8_t>& snapshot);
+
+  /**
+   *  Decodes a snapshot.
+   *  @param [in] index The snapshot, in the order pushed
+   *  @param [out] snapshot The snapshot, replaced
+   *  @return false if there is no such snapshot
+   */
+  bool restore(size_t index, std::vector<std::uint8_t>& snapshot) const;
+
+  void clear() noexcept;
+  size_t size() const noexcept;
+
+  /** The bytes the snapshots would take undeltaed. */
+  size_t rawBytes() const noexcept;
+
+  /** The bytes the deltas take. */
+  size_t encodedBytes() const noexcept;
+
+  /** The time spent encoding deltas, in seconds. */
+  double encodeSeconds() const noexcept;
+
+ private:
+  std::vector<std::uint8_t> deltas;
+  std::vector<size_t> offsets; /**< Where each delta starts. */
+  std::vector<std::uint8_t> last;
+  std::vector<std::uint8_t> delta;
+  size_t raw_bytes = 0;
+  double encode_seconds = 0;
+};
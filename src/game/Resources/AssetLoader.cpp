@@ -0,0 +1,158 @@
+#include "AssetLoader.h"
+#include "Profiler/Profiler.h"
+#include "TextureCache.h"
+#include <Engine/FileIO.h>
+#include <algorithm>
+
+AssetLoader::~AssetLoader()
+{
+  wait();
+}
+
+void AssetLoader::queue(const std::string& texture_file_name)
+{
+  const std::string& source_file =
+    TextureCache::getInstance().sourceFile(texture_file_name);
+
+  auto source = std::find(sources.begin(), sources.end(), source_file);
+  if (source == sources.end())
+  {
+    source = sources.insert(sources.end(), source_file);
+  }
+
+  Texture texture;
+  texture.file_name = texture_file_name;
+  texture.source = static_cast<size_t>(source - sources.begin());
+  textures.push_back(std::move(texture));
+}
+
+/**
+ *   @brief   Starts reading the queued files.
+ *   @details Textures packed into the same atlas page share a source
+ *            file, so each file is only read once however many
+ *            textures were queued from it.
+ *   @return  void
+ */
+void AssetLoader::start(size_t max_workers)
+{
+  started = std::chrono::steady_clock::now();
+  finished = started;
+
+  read_ok.assign(sources.size(), 0);
+  source_ready.assign(sources.size(), 0);
+  ready.reserve(sources.size());
+
+  size_t worker_count = max_workers;
+  if (worker_count == 0)
+  {
+    worker_count = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  worker_count = std::min(worker_count, sources.size());
+
+  for (size_t i = 0; i < worker_count; ++i)
+  {
+    workers.emplace_back(&AssetLoader::read, this);
+  }
+}
+
+/**
+ *   @brief   Worker thread body.
+ *   @details Claims the next unread file until none are left. Reading
+ *            the file pulls it off the disk while the main thread keeps
+ *            rendering, leaving only the decode and upload for the main
+ *            thread to do.
+ *   @return  void
+ */
+void AssetLoader::read()
+{
+  size_t source = 0;
+  while ((source = next_source++) < sources.size())
+  {
+    ScopedZone zone("read texture");
+
+    ASGE::FILEIO::File file;
+    if (file.open(sources[source]))
+    {
+      read_ok[source] = file.read().length > 0 ? 1 : 0;
+      file.close();
+    }
+
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    ready.push_back(source);
+  }
+}
+
+/**
+ *   @brief   Uploads the textures that are ready.
+ *   @details Textures are uploaded in the order they were queued, at
+ *            most budget per call, so a frame never stalls on more
+ *            than a handful of uploads.
+ *   @return  True once loading has finished.
+ */
+bool AssetLoader::upload(ASGE::Renderer* renderer, size_t budget)
+{
+  if (done())
+  {
+    return true;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    for (auto source : ready)
+    {
+      source_ready[source] = 1;
+    }
+    ready.clear();
+  }
+
+  for (; budget > 0 && uploaded < textures.size(); --budget)
+  {
+    auto& texture = textures[uploaded];
+    if (!source_ready[texture.source])
+    {
+      break;
+    }
+
+    if (read_ok[texture.source])
+    {
+      texture.sprite =
+        TextureCache::getInstance().load(renderer, texture.file_name);
+    }
+
+    load_failed = load_failed || !texture.sprite;
+    ++uploaded;
+  }
+
+  if (!done())
+  {
+    return false;
+  }
+
+  finished = std::chrono::steady_clock::now();
+  wait();
+  return true;
+}
+
+bool AssetLoader::done() const noexcept
+{
+  return uploaded == textures.size();
+}
+
+bool AssetLoader::failed() const noexcept
+{
+  return load_failed;
+}
+
+double AssetLoader::loadTime() const noexcept
+{
+  return std::chrono::duration<double, std::milli>(finished - started).count();
+}
+
+void AssetLoader::wait()
+{
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+  workers.clear();
+}
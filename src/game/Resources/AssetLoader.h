@@ -0,0 +1,89 @@
+#pragma once
+#include <Engine/Renderer.h>
+#include <Engine/Sprite.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ *  Streams textures in over several frames.
+ *  Worker threads read the texture files through ASGE::FILEIO in
+ *  parallel, then the main thread, which owns the GL context, uploads a
+ *  few of the textures that have been read each frame. Uploaded textures
+ *  are kept in the TextureCache, so the game objects created once
+ *  loading is done share them rather than loading them again.
+ *  @see TextureCache
+ */
+class AssetLoader
+{
+ public:
+  AssetLoader() = default;
+  ~AssetLoader();
+
+  AssetLoader(const AssetLoader&) = delete;
+  AssetLoader& operator=(const AssetLoader&) = delete;
+
+  /**
+   *  Adds a texture to be loaded. Must be called before start.
+   *  @param [in] texture_file_name The file path to the the texture to load
+   */
+  void queue(const std::string& texture_file_name);
+
+  /**
+   *  Starts the worker threads reading the queued textures.
+   *  @param [in] max_workers Upper limit on threads, zero uses one per core
+   */
+  void start(size_t max_workers = 0);
+
+  /**
+   *  Uploads textures whose files have been read. Main thread only.
+   *  @param [in] renderer The renderer used to perform the allocations
+   *  @param [in] budget The maximum number of textures to upload
+   *  @return true once every queued texture has been uploaded
+   */
+  bool upload(ASGE::Renderer* renderer, size_t budget);
+
+  /**
+   *  Blocks until the workers have read every queued file.
+   */
+  void wait();
+
+  bool done() const noexcept;
+  bool failed() const noexcept;
+
+  /**
+   *  Time from start to the last texture being uploaded.
+   *  @return the loading time, in milliseconds
+   */
+  double loadTime() const noexcept;
+
+ private:
+  void read();
+
+  struct Texture
+  {
+    std::string file_name;
+    size_t source = 0;
+    std::shared_ptr<ASGE::Sprite> sprite;
+  };
+
+  std::vector<Texture> textures;
+  std::vector<std::string> sources;
+  std::vector<std::uint8_t> read_ok;
+  std::vector<std::thread> workers;
+
+  std::atomic<size_t> next_source{ 0 };
+  std::mutex ready_mutex;
+  std::vector<size_t> ready;
+  std::vector<std::uint8_t> source_ready;
+
+  size_t uploaded = 0;
+  bool load_failed = false;
+  std::chrono::steady_clock::time_point started;
+  std::chrono::steady_clock::time_point finished;
+};
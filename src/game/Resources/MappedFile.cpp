@@ -0,0 +1,134 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& file_name)
+{
+  close();
+
+  HANDLE handle = CreateFileA(file_name.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(handle, &file_size) || file_size.QuadPart <= 0)
+  {
+    CloseHandle(handle);
+    return false;
+  }
+
+  HANDLE view_mapping =
+    CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (view_mapping == nullptr)
+  {
+    CloseHandle(handle);
+    return false;
+  }
+
+  const void* view = MapViewOfFile(view_mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr)
+  {
+    CloseHandle(view_mapping);
+    CloseHandle(handle);
+    return false;
+  }
+
+  file = handle;
+  mapping = view_mapping;
+  bytes = static_cast<const std::uint8_t*>(view);
+  length = static_cast<size_t>(file_size.QuadPart);
+  return true;
+}
+
+void MappedFile::close() noexcept
+{
+  if (bytes != nullptr)
+  {
+    UnmapViewOfFile(bytes);
+    CloseHandle(mapping);
+    CloseHandle(file);
+  }
+
+  bytes = nullptr;
+  length = 0;
+  file = nullptr;
+  mapping = nullptr;
+}
+#else
+bool MappedFile::open(const std::string& file_name)
+{
+  close();
+
+  const int descriptor = ::open(file_name.c_str(), O_RDONLY);
+  if (descriptor < 0)
+  {
+    return false;
+  }
+
+  struct stat status = {};
+  if (::fstat(descriptor, &status) != 0 || status.st_size <= 0)
+  {
+    ::close(descriptor);
+    return false;
+  }
+
+  const auto file_size = static_cast<size_t>(status.st_size);
+  void* view =
+    ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+  // the mapping holds its own reference to the file
+  ::close(descriptor);
+  if (view == MAP_FAILED)
+  {
+    return false;
+  }
+
+  bytes = static_cast<const std::uint8_t*>(view);
+  length = file_size;
+  return true;
+}
+
+void MappedFile::close() noexcept
+{
+  if (bytes != nullptr)
+  {
+    ::munmap(const_cast<std::uint8_t*>(bytes), length);
+  }
+
+  bytes = nullptr;
+  length = 0;
+}
+#endif
+
+const std::uint8_t* MappedFile::data() const noexcept
+{
+  return bytes;
+}
+
+size_t MappedFile::size() const noexcept
+{
+  return length;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ *  A read-only view of a whole file on disk.
+ *  The file is mapped into memory rather than read, so opening it costs
+ *  the same however large it is and its pages are only loaded as they
+ *  are touched. The view is valid until the file is closed.
+ */
+class MappedFile
+{
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   *  Maps a file, closing any mapped before.
+   *  @param [in] file_name The path of the file on disk
+   *  @return true if the file exists, is not empty and was mapped
+   */
+  bool open(const std::string& file_name);
+  void close() noexcept;
+
+  const std::uint8_t* data() const noexcept;
+  size_t size() const noexcept;
+
+ private:
+  const std::uint8_t* bytes = nullptr;
+  size_t length = 0;
+#ifdef _WIN32
+  void* file = nullptr;
+  void* mapping = nullptr;
+#endif
+};
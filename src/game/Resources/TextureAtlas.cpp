@@ -0,0 +1,69 @@
+#include "TextureAtlas.h"
+#include <Engine/DebugPrinter.h>
+#include <Engine/FileIO.h>
+#include <nlohmann/json.hpp>
+
+bool TextureAtlas::load(const std::string& manifest_file)
+{
+  ASGE::FILEIO::File file;
+  if (!file.open(manifest_file))
+  {
+    return false;
+  }
+
+  auto buffer = file.read();
+  file.close();
+
+  auto manifest = nlohmann::json::parse(
+    buffer.as_char(), buffer.as_char() + buffer.length, nullptr, false);
+  if (manifest.is_discarded() || !manifest.is_object())
+  {
+    ASGE::DebugPrinter{} << "invalid atlas manifest: " << manifest_file
+                         << std::endl;
+    return false;
+  }
+
+  pages.clear();
+  regions.clear();
+
+  for (const auto& page_file : manifest["pages"])
+  {
+    pages.push_back(page_file.get<std::string>());
+  }
+
+  for (auto sprite = manifest["sprites"].begin();
+       sprite != manifest["sprites"].end();
+       ++sprite)
+  {
+    AtlasRegion region;
+    region.page = sprite.value()["page"].get<size_t>();
+    region.x = sprite.value()["x"].get<float>();
+    region.y = sprite.value()["y"].get<float>();
+    region.width = sprite.value()["w"].get<float>();
+    region.height = sprite.value()["h"].get<float>();
+
+    if (region.page < pages.size())
+    {
+      regions[sprite.key()] = region;
+    }
+  }
+
+  return true;
+}
+
+const AtlasRegion*
+TextureAtlas::find(const std::string& texture_file_name) const
+{
+  auto region = regions.find(texture_file_name);
+  return region == regions.end() ? nullptr : &region->second;
+}
+
+const std::string& TextureAtlas::page(size_t index) const
+{
+  return pages[index];
+}
+
+bool TextureAtlas::empty() const noexcept
+{
+  return regions.empty();
+}
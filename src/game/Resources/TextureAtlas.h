@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ *  Where a packed image lives inside an atlas.
+ */
+struct AtlasRegion
+{
+  size_t page = 0;
+  float x = 0;
+  float y = 0;
+  float width = 0;
+  float height = 0;
+};
+
+/**
+ *  The rect manifest produced by the atlas packer at build time.
+ *  Maps the original path of every packed image to the atlas page it
+ *  was packed on and its sub-rect within that page.
+ *  @see tools/pack_atlas.py
+ */
+class TextureAtlas
+{
+ public:
+  /**
+   *  Reads a manifest written by the atlas packer.
+   *  @param [in] manifest_file The path to the manifest json
+   *  @return true if the manifest was found and parsed
+   */
+  bool load(const std::string& manifest_file);
+
+  /**
+   *  Looks up a packed image.
+   *  @param [in] texture_file_name The path the image was packed from
+   *  @return the region, or nullptr if the image is not in the atlas
+   */
+  const AtlasRegion* find(const std::string& texture_file_name) const;
+
+  /**
+   *  The texture file of a page.
+   *  @param [in] index The page number stored in a region
+   *  @return the path of the page's texture
+   */
+  const std::string& page(size_t index) const;
+
+  bool empty() const noexcept;
+
+ private:
+  std::vector<std::string> pages;
+  std::unordered_map<std::string, AtlasRegion> regions;
+};
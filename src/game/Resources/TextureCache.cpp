@@ -0,0 +1,85 @@
+#include "TextureCache.h"
+
+TextureCache& TextureCache::getInstance()
+{
+  static TextureCache instance;
+  return instance;
+}
+
+std::shared_ptr<ASGE::Sprite>
+TextureCache::load(ASGE::Renderer* renderer,
+                   const std::string& texture_file_name)
+{
+  auto& entry = textures[texture_file_name];
+  if (auto sprite = entry.lock())
+  {
+    return sprite;
+  }
+
+  std::shared_ptr<ASGE::Sprite> sprite(renderer->createRawSprite());
+  if (!loadTexture(*sprite, texture_file_name))
+  {
+    textures.erase(texture_file_name);
+    return nullptr;
+  }
+
+  entry = sprite;
+  return sprite;
+}
+
+bool TextureCache::loadAtlas(const std::string& manifest_file)
+{
+  return atlas.load(manifest_file) && !atlas.empty();
+}
+
+/**
+ *   @brief   Loads a texture, preferring the atlas.
+ *   @details Packed textures load the whole atlas page, which the
+ *            engine only uploads once, then narrow the sprite down to
+ *            the packed image using its source rectangle.
+ *   @return  True if the texture was loaded.
+ */
+bool TextureCache::loadTexture(ASGE::Sprite& sprite,
+                               const std::string& texture_file_name)
+{
+  const AtlasRegion* region = atlas.find(texture_file_name);
+  if (region == nullptr)
+  {
+    return sprite.loadTexture(texture_file_name);
+  }
+
+  if (!sprite.loadTexture(atlas.page(region->page)))
+  {
+    return false;
+  }
+
+  float* src_rect = sprite.srcRect();
+  src_rect[0] = region->x;
+  src_rect[1] = region->y;
+  src_rect[2] = region->width;
+  src_rect[3] = region->height;
+
+  sprite.width(region->width);
+  sprite.height(region->height);
+  return true;
+}
+
+const std::string&
+TextureCache::sourceFile(const std::string& texture_file_name) const
+{
+  const AtlasRegion* region = atlas.find(texture_file_name);
+  return region == nullptr ? texture_file_name : atlas.page(region->page);
+}
+
+size_t TextureCache::size() const
+{
+  size_t live = 0;
+  for (const auto& texture : textures)
+  {
+    if (!texture.second.expired())
+    {
+      ++live;
+    }
+  }
+  return live;
+}
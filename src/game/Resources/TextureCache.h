@@ -0,0 +1,74 @@
+#pragma once
+#include "TextureAtlas.h"
+#include <Engine/Renderer.h>
+#include <Engine/Sprite.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ *  Reference counted cache of loaded textures, keyed by file path.
+ *  ASGE only exposes textures through the sprite that loaded them, so
+ *  the cache hands out a shared sprite per texture. The first request
+ *  for a path loads it, every later request shares the same sprite and
+ *  texture, and the entry is released once the last user lets go.
+ *  As the sprite is shared, its position must be set by each user
+ *  immediately before it is rendered. When an atlas is loaded, images
+ *  packed into it are bound to their sub-rect of the atlas page rather
+ *  than loaded from their own file.
+ *  @see SpriteComponent
+ */
+class TextureCache
+{
+ public:
+  static TextureCache& getInstance();
+
+  TextureCache(const TextureCache&) = delete;
+  TextureCache& operator=(const TextureCache&) = delete;
+
+  /**
+   *  Returns the sprite for a texture, loading it on first use.
+   *  @param [in] renderer The renderer used to perform the allocations
+   *  @param [in] texture_file_name The file path to the the texture to load
+   *  @return the shared sprite, or nullptr if the texture failed to load
+   */
+  std::shared_ptr<ASGE::Sprite>
+  load(ASGE::Renderer* renderer, const std::string& texture_file_name);
+
+  /**
+   *  Loads the rect manifest of a packed texture atlas.
+   *  Textures loaded afterwards use the atlas when they are packed in it.
+   *  @param [in] manifest_file The path to the manifest json
+   *  @return true if the atlas can be used
+   */
+  bool loadAtlas(const std::string& manifest_file);
+
+  /**
+   *  Loads a texture on to a sprite, binding it to its atlas sub-rect
+   *  when the texture has been packed.
+   *  @param [in] sprite The sprite to load the texture on to
+   *  @param [in] texture_file_name The file path to the the texture to load
+   *  @return true if the texture was loaded
+   */
+  bool loadTexture(ASGE::Sprite& sprite, const std::string& texture_file_name);
+
+  /**
+   *  The file a texture is read from, its atlas page if it was packed.
+   *  @param [in] texture_file_name The file path to the the texture
+   *  @return the path of the file holding the texture's pixels
+   */
+  const std::string& sourceFile(const std::string& texture_file_name) const;
+
+  /**
+   *  The number of textures currently loaded and in use.
+   *  @return the count of live entries
+   */
+  size_t size() const;
+
+ private:
+  TextureCache() = default;
+  ~TextureCache() = default;
+
+  std::unordered_map<std::string, std::weak_ptr<ASGE::Sprite>> textures;
+  TextureAtlas atlas;
+};
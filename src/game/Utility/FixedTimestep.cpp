@@ -0,0 +1,60 @@
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(unsigned int tick_rate,
+                             unsigned int max_ticks) noexcept :
+  tick_seconds(1.0 / tick_rate),
+  max_ticks_per_frame(max_ticks)
+{
+}
+
+/**
+ *   @brief   Banks the frame time.
+ *   @details The accumulator is only ever reduced by whole ticks, so the
+ *            tick count for a stream of frame times is exact and the
+ *            simulation itself never sees the variable frame time.
+ *   @return  The number of ticks due.
+ */
+unsigned int FixedTimestep::advance(double frame_seconds) noexcept
+{
+  accumulator += frame_seconds;
+
+  unsigned int due = 0;
+  while (accumulator >= tick_seconds && due < max_ticks_per_frame)
+  {
+    accumulator -= tick_seconds;
+    ++due;
+  }
+
+  if (due == max_ticks_per_frame && accumulator >= tick_seconds)
+  {
+    accumulator = 0;
+  }
+
+  return due;
+}
+
+void FixedTimestep::endTick() noexcept
+{
+  ++ticks;
+}
+
+float FixedTimestep::alpha() const noexcept
+{
+  return static_cast<float>(accumulator / tick_seconds);
+}
+
+float FixedTimestep::step() const noexcept
+{
+  return static_cast<float>(tick_seconds);
+}
+
+unsigned long long FixedTimestep::tick() const noexcept
+{
+  return ticks;
+}
+
+void FixedTimestep::rewind(unsigned long long tick_count) noexcept
+{
+  ticks = tick_count;
+  accumulator = 0;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ *  Converts variable frame times into a whole number of fixed ticks.
+ *  Frame time is banked in an accumulator and spent one tick at a time,
+ *  so the simulation always integrates with the same step however fast
+ *  the display refreshes. The time left over is exposed as an alpha for
+ *  interpolating the rendered positions between the last two ticks.
+ */
+class FixedTimestep
+{
+ public:
+  /**
+   *  @param [in] tick_rate The number of ticks to simulate per second
+   *  @param [in] max_ticks Ticks allowed per frame before time is dropped
+   */
+  explicit FixedTimestep(unsigned int tick_rate = 120,
+                         unsigned int max_ticks = 8) noexcept;
+
+  /**
+   *  Banks a frame's worth of time.
+   *  Time beyond max_ticks is discarded, so a long stall slows the game
+   *  down rather than making every following frame catch up.
+   *  @param [in] frame_seconds The time the last frame took
+   *  @return the number of ticks to simulate this frame
+   */
+  unsigned int advance(double frame_seconds) noexcept;
+
+  /**
+   *  Counts a tick as simulated, once the simulation has run it.
+   */
+  void endTick() noexcept;
+
+  /**
+   *  How far the frame is between the last tick and the next.
+   *  @return 0 at the last tick, approaching 1 at the next
+   */
+  float alpha() const noexcept;
+
+  /**
+   *  The length of a tick, passed to the simulation as its delta time.
+   *  @return the tick length in seconds
+   */
+  float step() const noexcept;
+
+  /**
+   *  The number of ticks simulated so far.
+   *  @return ticks since the timestep was created
+   */
+  unsigned long long tick() const noexcept;
+
+  /**
+   *  Sets the tick count, as when a saved game is restored. Any banked
+   *  time is dropped along with the ticks it was due to become.
+   *  @param [in] tick_count The number of ticks simulated
+   */
+  void rewind(unsigned long long tick_count) noexcept;
+
+ private:
+  double tick_seconds;
+  double accumulator = 0;
+  unsigned int max_ticks_per_frame;
+  unsigned long long ticks = 0;
+};
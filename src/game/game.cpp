@@ -5,16 +5,104 @@
 #include <Engine/InputEvents.h>
 #include <Engine/Keys.h>
 #include <Engine/Sprite.h>
+#include <algorithm>
 #include <cmath>
-//#include <GameObjects/GameObject.h>
+#include <limits>
 #include "game.h"
+#include "Profiler/Profiler.h"
+#include "Replay/Snapshot.h"
+#include "Resources/TextureCache.h"
+#include <cstdio>
+
+namespace
+{
+  const char* const DEFENDER_TEXTURE = "/data/images/defender.png";
+  const char* const ALIEN_TEXTURE = "/data/images/green_alien.png";
+  const char* const LASER_TEXTURE =
+    "/data/images/SpaceShooterRedux/PNG/Lasers/laserRed01.png";
+  const char* const ALIEN_LASER_TEXTURE =
+    "/data/images/SpaceShooterRedux/PNG/Lasers/laserGreen01.png";
+  const char* const BARRIER_TEXTURE = "/data/images/barrier.png";
+  const char* const EARTH_TEXTURE = "/data/images/destroyed_earth.png";
+
+  // ids of the textures in the frame renderer, registered in this order
+  enum SpriteId : std::uint16_t
+  {
+    DEFENDER_SPRITE,
+    ALIEN_SPRITE,
+    LASER_SPRITE,
+    ALIEN_LASER_SPRITE,
+    BARRIER_SPRITE,
+    EARTH_SPRITE
+  };
+
+  const char* const SPRITE_TEXTURES[] = { DEFENDER_TEXTURE, ALIEN_TEXTURE,
+                                          LASER_TEXTURE,    ALIEN_LASER_TEXTURE,
+                                          BARRIER_TEXTURE,  EARTH_TEXTURE };
+
+  // draw depths, later layers are drawn over earlier ones
+  const std::int16_t BACKDROP_Z = 0;
+  const std::int16_t ENTITY_Z = 1;
+  const std::int16_t SHOT_Z = 2;
+
+  // the most lines of text a frame shows
+  const size_t FRAME_TEXTS = 8;
+  const float MENU_MARKER_INDENT = 12.0F;
+
+  // textures uploaded per frame while the menu is shown
+  const size_t UPLOADS_PER_FRAME = 1;
+
+  const float PLAYER_SHOT_SPEED = -450.0F;
+  const float ALIEN_SHOT_SPEED = 300.0F;
+
+  // the waves designers define, and where they are kept once compiled
+  const char* const WAVES_FILE = "/data/waves/waves.json";
+  const char* const WAVE_CACHE_FILE = "waves.cache";
+
+  const int ALIEN_HIT_POINTS = 1;
+
+  // each barrier is Barriers::COLUMNS by Barriers::ROWS cells
+  const float BARRIER_CELL = 4.0F;
+
+  // below this the systems' work is too small to be worth a thread
+  const size_t PARALLEL_SYSTEM_ENTITIES = 4096;
+
+  const char SNAPSHOT_MAGIC[4] = { 'S', 'I', 'S', 'S' };
+  const std::uint32_t SNAPSHOT_VERSION = 1;
+
+  /** What a snapshot must match to be restored into the game. */
+  struct SnapshotHeader
+  {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t wave;
+    std::uint32_t aliens;
+    std::uint32_t barriers;
+    std::uint32_t player_shots;
+    std::uint32_t alien_shots;
+  };
+
+  enum SnapshotFlag : std::uint32_t
+  {
+    IN_MENU = 1U,
+    IN_GAME = 1U << 1U,
+    IN_PAUSE = 1U << 2U,
+    WIN = 1U << 3U,
+    LOSE = 1U << 4U,
+    SHOOT = 1U << 5U,
+    NEXT_WAVE = 1U << 6U
+  };
+}
 
 /**
  *   @brief   Default Constructor.
  *   @details Consider setting the game's width and height
  *            and even seeding the random number generator.
  */
-SpaceInvaders::SpaceInvaders()
+SpaceInvaders::SpaceInvaders() :
+  launch_time(std::chrono::steady_clock::now()),
+  quadratic_path({ QUADRATIC_HEIGHT, 0, QUADRATIC_CURVE }, QUADRATIC_ORIGIN),
+  sine_path(sineRise, SINE_PERIOD, SINE_SAMPLES)
 {
   game_name = "Space Invaders";
 }
@@ -33,9 +121,10 @@ SpaceInvaders::~SpaceInvaders()
 
 /**
  *   @brief   Initialises the game.
- *   @details The game window is created and all assets required to
- *            run the game are loaded. The keyHandler and clickHandler
- *            callback should also be set in the initialise function.
+ *   @details The game window is created and the assets required to
+ *            run the game start streaming in, so the menu can be shown
+ *            straight away. The keyHandler and clickHandler callback
+ *            should also be set in the initialise function.
  *   @return  True if the game initialised correctly.
  */
 bool SpaceInvaders::init()
@@ -46,18 +135,41 @@ bool SpaceInvaders::init()
     return false;
   }
 
-  initDefender();
-  initAliens();
-  initLasers();
-  initBarriers();
-  initEarth();
+  // packed at build time, textures load individually without it
+  TextureCache::getInstance().loadAtlas("/data/atlas/atlas.json");
+
+  // a scenario set up front is played as it is, in place of the waves
+  if (!scenario_set && waves.load(WAVES_FILE, WAVE_CACHE_FILE))
+  {
+    ASGE::DebugPrinter{} << waves.size() << " waves "
+                         << (waves.cached() ? "mapped from " : "compiled to ")
+                         << WAVE_CACHE_FILE << std::endl;
+  }
+
+  for (auto texture : SPRITE_TEXTURES)
+  {
+    assets.queue(texture);
+  }
+  assets.start();
+
+  jobs.start();
+  initSystems();
+
+#ifdef HEADLESS
+  // headless runs are measured in ticks, so finish loading up front
+  assets.wait();
+  streamAssets(std::numeric_limits<size_t>::max());
+#endif
 
   toggleFPS();
 
   renderer->setClearColour(ASGE::COLOURS::BLACK);
 
-  // input handling functions
-  inputs->use_threads = false;
+  // frames are drawn sorted by texture, so let same texture draws batch
+  renderer->setSpriteMode(ASGE::SpriteSortMode::DEFERRED);
+
+  // input handling functions, which only queue the events for simulate
+  inputs->use_threads = true;
 
   key_callback_id =
     inputs->addCallbackFnc(ASGE::E_KEY, &SpaceInvaders::keyHandler, this);
@@ -68,114 +180,570 @@ bool SpaceInvaders::init()
   return true;
 }
 
-bool SpaceInvaders::initDefender()
+/**
+ *   @brief   Sets the scenario every level is built from
+ *   @details Counts the game divides by are clamped to at least one, as
+ *            they are when waves are compiled.
+ *   @return  void
+ */
+void SpaceInvaders::setScenario(const Scenario& level)
+{
+  scenario = level;
+  scenario.aliens = std::max<size_t>(1, scenario.aliens);
+  scenario.aliens_per_row = std::max<size_t>(1, scenario.aliens_per_row);
+  scenario.fire_interval = std::max(1U, scenario.fire_interval);
+  scenario_set = true;
+}
+
+/**
+ *   @brief   Uploads the next streamed assets.
+ *   @details Once every texture is in, the game objects are created
+ *            from the cached textures and a game the player already
+ *            asked for is started.
+ *   @return  void
+ */
+void SpaceInvaders::streamAssets(size_t budget)
+{
+  if (!assets.upload(renderer.get(), budget))
+  {
+    return;
+  }
+
+  // ids are handed out in order, so each must match its SpriteId
+  bool registered = !assets.failed();
+  for (auto texture : SPRITE_TEXTURES)
+  {
+    const auto expected = static_cast<int>(frame_renderer.size());
+    registered = registered &&
+                 frame_renderer.addSprite(renderer.get(), texture) == expected;
+  }
+
+  if (!registered || !initShots() || !initLevel())
+  {
+    ASGE::DebugPrinter{} << "failed to load game assets" << std::endl;
+    signalExit();
+    return;
+  }
+
+  // sized for the largest wave, so later waves fit in the same memory
+  const size_t most_aliens = std::max(scenario.aliens, waves.mostAliens());
+  const size_t most_barriers =
+    std::max(scenario.barriers, waves.mostBarriers());
+
+  // every obstacle could hash to the same bucket
+  broad_phase.reserve(most_barriers + 1);
+  candidates.reserve(most_barriers + 1);
+  packed_aliens.reserve(most_aliens);
+  kills.reserve(most_aliens);
+
+  const size_t chunks = most_aliens / SYSTEM_GRAIN + 1;
+  chunk_landed.resize(chunks);
+  chunk_candidates.resize(chunks);
+  chunk_crushed.resize(chunks);
+  for (size_t chunk = 0; chunk < chunks; ++chunk)
+  {
+    chunk_candidates[chunk].reserve(most_barriers + 1);
+    chunk_crushed[chunk].reserve(SYSTEM_GRAIN * most_barriers);
+  }
+
+  const size_t frame_sprites = most_aliens +
+                               most_barriers * Barriers::MAX_DRAWS + 2 +
+                               scenario.player_shots + scenario.alien_shots;
+  frames.forEach([frame_sprites](FramePacket& packet) {
+    packet.reserve(frame_sprites, FRAME_TEXTS);
+  });
+  frame_renderer.reserve(frame_sprites, FRAME_TEXTS);
+
+  assets_ready = true;
+  ASGE::DebugPrinter{} << "assets streamed in " << assets.loadTime() << "ms"
+                       << std::endl;
+
+  if (start_on_load)
+  {
+    in_menu = false;
+    in_game = true;
+  }
+}
+
+void SpaceInvaders::recordInputs()
+{
+  recording_inputs = true;
+}
+
+bool SpaceInvaders::saveRecording(const std::string& file_name)
 {
-  if (!defender.addSpriteComponent(renderer.get(), "/data/images/defender.png"))
+  recording.length(timestep.tick());
+  return recording.save(file_name);
+}
+
+bool SpaceInvaders::replayInputs(const std::string& file_name)
+{
+  if (!replay.load(file_name))
   {
     return false;
   }
 
-  defender.spriteComponent()->getSprite()->xPos(
-    game_width / 2 - (defender.spriteComponent()->getSprite()->width() / 2));
-  defender.spriteComponent()->getSprite()->yPos(game_height - 100);
+  replaying_inputs = true;
+  return true;
+}
+
+unsigned long long SpaceInvaders::replayLength() const noexcept
+{
+  return replay.length();
 }
 
-bool SpaceInvaders::initAliens()
+unsigned long long SpaceInvaders::ticksRun() const noexcept
+{
+  return timestep.tick();
+}
+
+void SpaceInvaders::traceLatency(size_t expected_inputs)
+{
+  latency.enable(expected_inputs);
+}
+
+void SpaceInvaders::reportLatency(std::ostream& out) const
+{
+  latency.report(out);
+}
+
+/**
+ *   @brief   Saves the simulation
+ *   @details Only what the ticks change is saved. The level itself is
+ *            rebuilt from the wave on restore, and the aliens killed so
+ *            far are listed in the order they died, so killing them
+ *            again leaves every pool in the same order as when saved.
+ *            The components left are then saved as their dense arrays.
+ *   @return  void
+ */
+void SpaceInvaders::saveState(std::vector<std::uint8_t>& snapshot) const
 {
-  for (int i = 0; i < alien_count; i++)
+  snapshot.clear();
+  SnapshotWriter out(snapshot);
+
+  SnapshotHeader header = {};
+  std::copy(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC), header.magic);
+  header.version = SNAPSHOT_VERSION;
+  header.wave = static_cast<std::uint32_t>(wave);
+  header.aliens = static_cast<std::uint32_t>(scenario.aliens);
+  header.barriers = static_cast<std::uint32_t>(scenario.barriers);
+  header.player_shots = static_cast<std::uint32_t>(player_shots.capacity());
+  header.alien_shots = static_cast<std::uint32_t>(alien_shots.capacity());
+  out.write(header);
+
+  std::uint32_t flags = 0;
+  flags |= in_menu ? IN_MENU : 0U;
+  flags |= in_game ? IN_GAME : 0U;
+  flags |= in_pause ? IN_PAUSE : 0U;
+  flags |= win ? WIN : 0U;
+  flags |= lose ? LOSE : 0U;
+  flags |= shoot ? SHOOT : 0U;
+  flags |= next_wave ? NEXT_WAVE : 0U;
+
+  out.write(timestep.tick());
+  out.write(flags);
+  out.write(score);
+  out.write(aliens_left);
+  out.write(menu_option);
+  out.write(alien_x_velocity);
+  out.write(alien_y_velocity);
+  out.write(alien_y_pos);
+  out.write(alien_fire_state);
+
+  out.writeArray(kills.data(), kills.size());
+  out.writeArray(registry.transforms.data(), registry.transforms.size());
+  out.writeArray(registry.velocities.data(), registry.velocities.size());
+  out.writeArray(registry.healths.data(), registry.healths.size());
+
+  formation.writeState(out);
+  barriers.writeState(out);
+  player_shots.writeState(out);
+  alien_shots.writeState(out);
+}
+
+/**
+ *   @brief   Restores the simulation
+ *   @details The snapshot's wave is rebuilt and its kills replayed, then
+ *            everything the ticks changed is read over the top. Each
+ *            array must be the length the rebuilt level expects, which
+ *            catches a snapshot of a level built differently.
+ *   @return  True if the snapshot was restored.
+ */
+bool SpaceInvaders::restoreState(const std::vector<std::uint8_t>& snapshot)
+{
+  SnapshotReader in(snapshot.data(), snapshot.size());
+
+  SnapshotHeader header = {};
+  if (!in.read(header) ||
+      !std::equal(std::begin(SNAPSHOT_MAGIC),
+                  std::end(SNAPSHOT_MAGIC),
+                  header.magic) ||
+      header.version != SNAPSHOT_VERSION ||
+      header.wave >= std::max<size_t>(waves.size(), 1) ||
+      header.player_shots != player_shots.capacity() ||
+      header.alien_shots != alien_shots.capacity())
   {
-    if (!aliens[i].addSpriteComponent(renderer.get(),
-                                      "/data/images/green_alien.png"))
-    {
-      return false;
-    }
+    return false;
+  }
 
-    aliens[i].visibility = true;
+  // kept for a fresh level, should the snapshot fail part way through
+  const size_t kept_wave = wave;
+  const int kept_score = score;
+  const int kept_menu_option = menu_option;
+  const std::uint32_t kept_fire_state = alien_fire_state;
 
-    if (i < 10)
-    {
-      aliens[i].spriteComponent()->getSprite()->xPos((i * 40) + 100);
-      aliens[i].spriteComponent()->getSprite()->yPos(alien_y_pos);
-    }
-    else if (i >= 10 && i < 20)
-    {
-      aliens[i].spriteComponent()->getSprite()->xPos(((i - 10) * 40) + 100);
-      aliens[i].spriteComponent()->getSprite()->yPos(2 * alien_y_pos);
-    }
-    else if (i >= 20 && i < 30)
+  wave = header.wave;
+  if (!initLevel())
+  {
+    signalExit();
+    return false;
+  }
+
+  unsigned long long tick_count = 0;
+  std::uint32_t flags = 0;
+  bool restored =
+    header.aliens == scenario.aliens && header.barriers == scenario.barriers &&
+    in.read(tick_count) && in.read(flags) && in.read(score) &&
+    in.read(aliens_left) && in.read(menu_option) &&
+    in.read(alien_x_velocity) && in.read(alien_y_velocity) &&
+    in.read(alien_y_pos) && in.read(alien_fire_state) &&
+    in.readArray(kills, scenario.aliens);
+
+  for (size_t i = 0; restored && i < kills.size(); ++i)
+  {
+    const Entity alien = kills[i];
+    restored = registry.slots.contains(alien);
+    if (restored)
     {
-      aliens[i].spriteComponent()->getSprite()->xPos(((i - 20) * 40) + 100);
-      aliens[i].spriteComponent()->getSprite()->yPos(3 * alien_y_pos);
+      const FormationSlot slot = registry.slots.get(alien);
+      registry.destroy(alien);
+      formation.kill(slot.column, slot.row);
     }
-    else if (i >= 30 && i < 40)
+  }
+
+  restored =
+    restored &&
+    in.readArray(registry.transforms.data(), registry.transforms.size()) &&
+    in.readArray(registry.velocities.data(), registry.velocities.size()) &&
+    in.readArray(registry.healths.data(), registry.healths.size()) &&
+    formation.readState(in) && barriers.readState(in) &&
+    player_shots.readState(in) && alien_shots.readState(in) && in.done();
+
+  if (!restored)
+  {
+    wave = kept_wave;
+    score = kept_score;
+    menu_option = kept_menu_option;
+    alien_fire_state = kept_fire_state;
+    if (!initLevel())
     {
-      aliens[i].spriteComponent()->getSprite()->xPos(((i - 30) * 40) + 100);
-      aliens[i].spriteComponent()->getSprite()->yPos(4 * alien_y_pos);
+      signalExit();
     }
-    else
+    return false;
+  }
+
+  in_menu = (flags & IN_MENU) != 0;
+  in_game = (flags & IN_GAME) != 0;
+  in_pause = (flags & IN_PAUSE) != 0;
+  win = (flags & WIN) != 0;
+  lose = (flags & LOSE) != 0;
+  shoot = (flags & SHOOT) != 0;
+  next_wave = (flags & NEXT_WAVE) != 0;
+
+  timestep.rewind(tick_count);
+  alien_fire_rng.seed(alien_fire_state);
+  ++static_version;
+  return true;
+}
+
+bool SpaceInvaders::rebuildLevel()
+{
+  return initLevel();
+}
+
+const Arena& SpaceInvaders::levelArena() const noexcept
+{
+  return level_arena;
+}
+
+void SpaceInvaders::keepHistory(size_t expected_ticks)
+{
+  state_history.clear();
+  state_history.reserve(expected_ticks);
+  keeping_history = true;
+}
+
+const StateHistory& SpaceInvaders::history() const noexcept
+{
+  return state_history;
+}
+
+/**
+ *   @brief   Feeds the replay into the game.
+ *   @details Applies every event recorded before the coming tick, just
+ *            as they were taken from the input queue in the recorded
+ *            session, then ends the game once the session's ticks have
+ *            all been simulated or the game is over.
+ *   @return  void
+ */
+void SpaceInvaders::playInputs()
+{
+  while (const RecordedKey* recorded = replay.next(timestep.tick()))
+  {
+    input_event.key = recorded->key;
+    input_event.action = recorded->action;
+    input_event.mods = recorded->mods;
+    if (applyInput(input_event) && latency.enabled())
     {
-      aliens[i].spriteComponent()->getSprite()->xPos(((i - 40) * 40) + 100);
-      aliens[i].spriteComponent()->getSprite()->yPos(5 * alien_y_pos);
+      // replayed keys count as delivered when the frame began
+      latency.applied(frame_start, timestep.tick());
     }
   }
+
+  if (timestep.tick() >= replay.length() || win || lose)
+  {
+    signalExit();
+  }
+}
+
+/**
+ *   @brief   Builds the level
+ *   @details Everything the last level created in the level arena is
+ *            destroyed in one step, then the level is rebuilt in the
+ *            same memory, so a restart does not go back to the heap for
+ *            its components.
+ *   @return  True if every game object was created.
+ */
+bool SpaceInvaders::initLevel()
+{
+  registry.clear();
+  player_shots.clear();
+  alien_shots.clear();
+  level_arena.reset();
+  kills.clear();
+
+  if (!waves.empty())
+  {
+    waves.apply(wave, scenario);
+  }
+
+  aliens_left = static_cast<int>(scenario.aliens);
+  win = false;
+  lose = false;
+
+  alien_x_velocity = scenario.speed;
+  alien_y_velocity = 0;
+  alien_y_pos = scenario.top;
+  ++static_version;
+
+  registry.reserve(scenario.aliens + 2);
+  if (!initDefender() || !initAliens() || !initBarriers() || !initEarth())
+  {
+    return false;
+  }
+
+  storePositions(registry, jobs);
+  formation.storePosition();
+  return true;
+}
+
+/**
+ *   @brief   Lists the systems run each tick
+ *   @details Each system declares what it reads and writes, so the
+ *            schedule can run those that share nothing side by side.
+ *            The order they are added in is the order they run in
+ *            whenever they do conflict.
+ *   @return  void
+ */
+void SpaceInvaders::initSystems()
+{
+  systems.clear();
+
+  systems.add("storePositions",
+              0,
+              TRANSFORM_ACCESS | FORMATION_ACCESS,
+              [this](float) {
+                storePositions(registry, jobs);
+                formation.storePosition();
+              });
+
+  systems.add("alienMovement",
+              0,
+              FORMATION_ACCESS | GAME_STATE_ACCESS,
+              [this](float dt) { alienMovement(dt); });
+
+  systems.add("integrate",
+              VELOCITY_ACCESS,
+              TRANSFORM_ACCESS,
+              [this](float dt) { integrate(registry, dt, jobs); });
+
+  if (scenario.autofire > 0)
+  {
+    systems.add("defenderFire",
+                TRANSFORM_ACCESS | COLLIDER_ACCESS,
+                PLAYER_SHOT_ACCESS,
+                [this](float) {
+                  for (size_t shot = 0; shot < scenario.autofire; ++shot)
+                  {
+                    if (!defenderFire())
+                    {
+                      return;
+                    }
+                  }
+                });
+  }
+
+  systems.add("playerShots", 0, PLAYER_SHOT_ACCESS, [this](float dt) {
+    moveShots(player_shots, dt);
+  });
+
+  systems.add("alienFire",
+              TRANSFORM_ACCESS | COLLIDER_ACCESS | FORMATION_ACCESS,
+              ALIEN_SHOT_ACCESS,
+              [this](float) { alienFire(); });
+
+  systems.add("alienShots", 0, ALIEN_SHOT_ACCESS, [this](float dt) {
+    moveShots(alien_shots, dt);
+  });
+
+  systems.add("collision", ALL_ACCESS, ALL_ACCESS, [this](float) {
+    buildBroadPhase();
+    packFormation(registry, formation, packed_aliens, jobs);
+    laserCollisions();
+    alienShotCollisions();
+    alienCollisions();
+  });
+}
+
+bool SpaceInvaders::initDefender()
+{
+  if (!defender.create(registry, renderer.get(), DEFENDER_TEXTURE))
+  {
+    return false;
+  }
+
+  Collider& collider = registry.colliders.get(defender.entity());
+  collider.layer = DEFENDER_LAYER;
+  registry.drawables.add(defender.entity(),
+                         Drawable{ DEFENDER_SPRITE, ENTITY_Z });
+
+  Transform* transform = defender.transform();
+  transform->x = static_cast<float>(game_width) / 2 - (collider.width / 2);
+  transform->y = static_cast<float>(game_height - 100);
+
+  return true;
 }
 
-bool SpaceInvaders::initLasers()
+/**
+ *   @brief   Fills the formation with aliens
+ *   @details Aliens are placed by their slot in the formation rather
+ *            than by a transform of their own, so they move with it.
+ *   @return  True if every alien was created.
+ */
+bool SpaceInvaders::initAliens()
 {
-  for (int i = 0; i < laser_count; i++)
+  Collider collider{ 0, 0, ALIEN_LAYER };
+
+  const size_t columns = scenario.aliens_per_row;
+  for (size_t i = 0; i < scenario.aliens; i++)
   {
-    if (!lasers[i].addSpriteComponent(renderer.get(),
-                                      "/data/images/SpaceShooterRedux/PNG/"
-                                      "Lasers/laserRed01.png"))
+    const Entity alien = registry.create();
+    SpriteComponent* sprite =
+      registry.addSprite(alien, renderer.get(), ALIEN_TEXTURE, true);
+    if (sprite == nullptr)
     {
       return false;
     }
 
-    lasers[i].spriteComponent()->getSprite()->yPos(
-      defender.spriteComponent()->getSprite()->yPos() -
-      lasers[i].spriteComponent()->getSprite()->height());
+    collider.width = sprite->getSprite()->width();
+    collider.height = sprite->getSprite()->height();
+    registry.colliders.add(alien, collider);
+    registry.drawables.add(alien, Drawable{ ALIEN_SPRITE, ENTITY_Z });
+    registry.healths.add(alien, Health{ ALIEN_HIT_POINTS });
+    registry.slots.add(
+      alien,
+      FormationSlot{ static_cast<std::uint32_t>(i % columns),
+                     static_cast<std::uint32_t>(i / columns) });
+  }
+
+  const size_t rows = (scenario.aliens + columns - 1) / columns;
+  formation.init(columns,
+                 rows,
+                 scenario.alien_spacing,
+                 scenario.row_spacing,
+                 collider.width,
+                 collider.height);
+
+  // a short last row leaves the rest of its slots empty
+  for (size_t i = scenario.aliens; i < columns * rows; i++)
+  {
+    formation.kill(static_cast<std::uint32_t>(i % columns),
+                   static_cast<std::uint32_t>(i / columns));
   }
+
+  formation.transform.x = scenario.left;
+  formation.transform.y = alien_y_pos;
+  return true;
+}
+
+bool SpaceInvaders::initShots()
+{
+  return player_shots.init(
+           renderer.get(), LASER_TEXTURE, scenario.player_shots) &&
+         alien_shots.init(
+           renderer.get(), ALIEN_LASER_TEXTURE, scenario.alien_shots);
 }
 
+/**
+ *   @brief   Builds the barriers
+ *   @details The barriers go where the wave placed them. Otherwise
+ *            they are spread evenly across the screen, half way down it.
+ *   @return  True if the barriers were built.
+ */
 bool SpaceInvaders::initBarriers()
 {
-  for (int i = 0; i < barrier_count; i++)
+  barriers.init(scenario.barriers, BARRIER_CELL);
+
+  if (!scenario.barrier_layout.empty())
   {
-    if (!barriers[i].addSpriteComponent(renderer.get(),
-                                        "/data/images/barrier.png"))
+    for (size_t i = 0; i < scenario.barriers; i++)
     {
-      return false;
+      const BarrierPlacement& placement = scenario.barrier_layout[i];
+      barriers.place(i, placement.x, placement.y);
     }
+    return true;
+  }
 
-    if (i < 13)
-    {
-      barriers[i].spriteComponent()->getSprite()->xPos(game_width * 0.25);
-      barriers[i].spriteComponent()->getSprite()->yPos(game_height / 2.0);
-    }
-    else if (i >= 13 && i < 25)
-    {
-      barriers[i].spriteComponent()->getSprite()->xPos(game_width * 0.5);
-      barriers[i].spriteComponent()->getSprite()->yPos(game_height / 2.0);
-    }
-    else
-    {
-      barriers[i].spriteComponent()->getSprite()->xPos(game_width * 0.75);
-      barriers[i].spriteComponent()->getSprite()->yPos(game_height / 2.0);
-    }
+  const auto spacing = static_cast<float>(game_width) /
+                       static_cast<float>(scenario.barriers + 1);
+  const auto barrier_y = static_cast<float>(game_height) / 2.0F;
+
+  for (size_t i = 0; i < scenario.barriers; i++)
+  {
+    const float centre = spacing * static_cast<float>(i + 1);
+    barriers.place(i, centre - barriers.box(i).width / 2, barrier_y);
   }
+
+  return true;
 }
 
 bool SpaceInvaders::initEarth()
 {
-  if (!earth.addSpriteComponent(renderer.get(),
-                                "/data/images/destroyed_earth.png"))
+  // a backdrop with no transform, so it is only drawn on game over
+  earth = registry.create();
+  SpriteComponent* sprite =
+    registry.addSprite(earth, renderer.get(), EARTH_TEXTURE, false);
+  if (sprite == nullptr)
   {
     return false;
   }
-  earth.spriteComponent()->getSprite()->xPos(
-    game_width / 2.0 - earth.spriteComponent()->getSprite()->width() / 2);
-  earth.spriteComponent()->getSprite()->yPos(
-    game_height / 2.0 - earth.spriteComponent()->getSprite()->height() / 2);
+
+  sprite->getSprite()->xPos(static_cast<float>(game_width) / 2 -
+                            sprite->getSprite()->width() / 2);
+  sprite->getSprite()->yPos(static_cast<float>(game_height) / 2 -
+                            sprite->getSprite()->height() / 2);
+
+  return true;
 }
 
 /**
@@ -202,9 +770,9 @@ void SpaceInvaders::setupResolution()
 /**
  *   @brief   Processes any key inputs
  *   @details This function is added as a callback to handle the game's
- *            keyboard input. For this game, calls to this function
- *            are thread safe, so you may alter the game's state as
- *            you see fit.
+ *            keyboard input. It may run on an input thread while the
+ *            game simulates, so it only queues the event, stamped with
+ *            the time it arrived, for the next tick to apply.
  *   @param   data The event data relating to key input.
  *   @see     KeyEvent
  *   @return  void
@@ -213,20 +781,102 @@ void SpaceInvaders::keyHandler(ASGE::SharedEventData data)
 {
   auto key = static_cast<const ASGE::KeyEvent*>(data.get());
 
-  if (key->key == ASGE::KEYS::KEY_ESCAPE)
+  InputCommand command;
+  command.key = key->key;
+  command.action = key->action;
+  command.mods = key->mods;
+  command.time = Profiler::now();
+  input_queue.push(command);
+}
+
+/**
+ *   @brief   Applies the queued key inputs
+ *   @details Called at every tick boundary, so an event waits at most
+ *            one tick once simulate is running. How long each waited
+ *            is recorded as a profiler zone.
+ *   @return  void
+ */
+void SpaceInvaders::drainInputs()
+{
+  InputCommand command;
+  while (input_queue.pop(command))
+  {
+    Profiler::getInstance().record(
+      "input latency", command.time, Profiler::now());
+
+    input_event.key = command.key;
+    input_event.action = command.action;
+    input_event.mods = command.mods;
+    if (applyInput(input_event) && latency.enabled())
+    {
+      latency.applied(command.time, timestep.tick());
+    }
+  }
+}
+
+/**
+ *   @brief   Applies a key input to the game
+ *   @details Runs as part of the simulation, between ticks. Starting a
+ *            new level creates sprites, which must be done on the thread
+ *            that owns the renderer, so it is left to the next update,
+ *            as is restoring the quick save.
+ *   @param   key The key event to apply.
+ *   @return  True if it moved the defender or fired a laser.
+ */
+bool SpaceInvaders::applyInput(const ASGE::KeyEvent& key)
+{
+  if (recording_inputs)
+  {
+    recording.record(timestep.tick(), key);
+  }
+
+  if (key.key == ASGE::KEYS::KEY_ESCAPE)
   {
     signalExit();
   }
 
-  if (key->key == ASGE::KEYS::KEY_P && key->action == ASGE::KEYS::KEY_PRESSED &&
+  if (key.key == ASGE::KEYS::KEY_GRAVE_ACCENT &&
+      key.action == ASGE::KEYS::KEY_PRESSED)
+  {
+    show_profiler = !show_profiler;
+  }
+  else if (key.key == ASGE::KEYS::KEY_T &&
+           key.action == ASGE::KEYS::KEY_PRESSED && show_profiler)
+  {
+    Profiler::getInstance().exportTrace("profile.json");
+  }
+
+  if (key.key == ASGE::KEYS::KEY_S && key.action == ASGE::KEYS::KEY_PRESSED &&
+      (in_game || in_pause))
+  {
+    saveState(quick_save);
+  }
+  else if (key.key == ASGE::KEYS::KEY_L &&
+           key.action == ASGE::KEYS::KEY_PRESSED && !quick_save.empty())
+  {
+    // rebuilding the level creates sprites, so the next update restores
+    restore_requested = true;
+    return false;
+  }
+
+  if ((win || lose) && key.key == ASGE::KEYS::KEY_ENTER &&
+      key.action == ASGE::KEYS::KEY_PRESSED)
+  {
+    // back to the menu, with a fresh level built by the next update
+    restart_level = true;
+    in_menu = true;
+    return false;
+  }
+
+  if (key.key == ASGE::KEYS::KEY_P && key.action == ASGE::KEYS::KEY_PRESSED &&
       in_pause)
   {
     // ASGE::DebugPrinter{} << "P pressed" << std::endl;
     in_pause = false;
     in_game = true;
   }
-  else if (key->key == ASGE::KEYS::KEY_P &&
-           key->action == ASGE::KEYS::KEY_PRESSED && in_game)
+  else if (key.key == ASGE::KEYS::KEY_P &&
+           key.action == ASGE::KEYS::KEY_PRESSED && in_game)
   {
     // ASGE::DebugPrinter{} << "P pressed" << std::endl;
     in_pause = true;
@@ -235,14 +885,14 @@ void SpaceInvaders::keyHandler(ASGE::SharedEventData data)
 
   if (in_menu)
   {
-    if (key->key == ASGE::KEYS::KEY_UP &&
-        key->action == ASGE::KEYS::KEY_RELEASED)
+    if (key.key == ASGE::KEYS::KEY_UP &&
+        key.action == ASGE::KEYS::KEY_RELEASED)
     {
       menu_option = menu_option - 1;
     }
 
-    else if (key->key == ASGE::KEYS::KEY_DOWN &&
-             key->action == ASGE::KEYS::KEY_RELEASED)
+    else if (key.key == ASGE::KEYS::KEY_DOWN &&
+             key.action == ASGE::KEYS::KEY_RELEASED)
     {
       menu_option = menu_option + 1;
     }
@@ -256,7 +906,12 @@ void SpaceInvaders::keyHandler(ASGE::SharedEventData data)
       menu_option = 3;
     }
 
-    if (key->key == ASGE::KEYS::KEY_ENTER)
+    if (key.key == ASGE::KEYS::KEY_ENTER && !assets_ready)
+    {
+      // starts as soon as the game's assets have streamed in
+      start_on_load = true;
+    }
+    else if (key.key == ASGE::KEYS::KEY_ENTER)
     {
       in_menu = false;
       in_game = true;
@@ -265,50 +920,37 @@ void SpaceInvaders::keyHandler(ASGE::SharedEventData data)
 
   if (in_game)
   {
-    if (key->key == ASGE::KEYS::KEY_A && key->action == ASGE::KEYS::KEY_PRESSED)
+    if (key.key == ASGE::KEYS::KEY_A && key.action == ASGE::KEYS::KEY_PRESSED)
     {
       defender.setVelocity(Vector2{ -450, 0 });
     }
 
-    else if (key->action == ASGE::KEYS::KEY_RELEASED)
+    else if (key.action == ASGE::KEYS::KEY_RELEASED)
     {
       defender.setVelocity(Vector2{ 0, 0 });
     }
 
-    if (key->key == ASGE::KEYS::KEY_D && key->action == ASGE::KEYS::KEY_PRESSED)
+    if (key.key == ASGE::KEYS::KEY_D && key.action == ASGE::KEYS::KEY_PRESSED)
     {
       defender.setVelocity(Vector2{ 450, 0 });
     }
-    else if (key->action == ASGE::KEYS::KEY_RELEASED)
+    else if (key.action == ASGE::KEYS::KEY_RELEASED)
     {
       defender.setVelocity(Vector2{ 0, 0 });
     }
 
     // DEFENDER LASER FIRING
-    if (key->key == ASGE::KEYS::KEY_SPACE &&
-        key->action == ASGE::KEYS::KEY_PRESSED && !lasers[0].visibility)
+    if (key.key == ASGE::KEYS::KEY_SPACE &&
+        key.action == ASGE::KEYS::KEY_PRESSED)
     {
-      lasers[current_shot_index].spriteComponent()->getSprite()->xPos(
-        defender.spriteComponent()->getSprite()->xPos() +
-        defender.spriteComponent()->getSprite()->width() / 2 -
-        lasers[current_shot_index].spriteComponent()->getSprite()->width() / 2);
-
-      lasers[current_shot_index].spriteComponent()->getSprite()->yPos(
-        defender.spriteComponent()->getSprite()->yPos() -
-        lasers[current_shot_index].spriteComponent()->getSprite()->height());
-
-      shoot = true;
-
-      lasers[current_shot_index].visibility = true;
-      lasers[current_shot_index].setVelocity(Vector2{ 0, -450 });
-
-      current_shot_index++;
-      if (current_shot_index == 5)
-      {
-        current_shot_index = 0;
-      }
+      shoot = defenderFire();
+      return shoot;
     }
+
+    return key.key == ASGE::KEYS::KEY_A || key.key == ASGE::KEYS::KEY_D;
   }
+
+  return false;
 }
 
 /**
@@ -332,397 +974,732 @@ void SpaceInvaders::clickHandler(ASGE::SharedEventData data)
   ASGE::DebugPrinter{} << "y_pos: " << y_pos << std::endl;
 }
 
-void SpaceInvaders::linearAlienMovement(const ASGE::GameTime& game_time)
+void SpaceInvaders::linearAlienMovement(float /*dt*/)
 {
-  auto dt_sec = game_time.delta.count() / 1000.0;
+  formation.velocity = Velocity{ alien_x_velocity, 0 };
+  formation.transform.y = alien_y_pos;
+  formation.flatten();
+}
 
-  for (int i = 0; i < alien_count; i++)
-  {
-    aliens[i].setVelocity(Vector2{ alien_x_velocity, 0 });
-    aliens[i].spriteComponent()->getSprite()->xPos(
-      aliens[i].spriteComponent()->getSprite()->xPos() +
-      aliens[i].getVelocity().x * dt_sec);
+/**
+ *   @brief   Drops the formation under gravity.
+ *   @details The formation's fall velocity is accelerated once per
+ *            tick, so the fall rate does not depend on how many updates
+ *            run per second.
+ *   @return  void
+ */
+void SpaceInvaders::gravitationalAlienMovement(float dt)
+{
+  formation.velocity = Velocity{ alien_x_velocity, alien_y_velocity };
+  formation.flatten();
 
-    if (i < 10)
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(alien_y_pos);
-    }
-    else if (i >= 10 && i < 20)
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(20 + alien_y_pos);
-    }
-    else if (i >= 20 && i < 30)
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(40 + alien_y_pos);
-    }
-    else if (i >= 30 && i < 40)
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(60 + alien_y_pos);
-    }
-    else
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(80 + alien_y_pos);
-    }
-  }
+  alien_y_velocity += scenario.gravity * dt;
 }
-void SpaceInvaders::gravitationalAlienMovement(const ASGE::GameTime& game_time)
+
+/**
+ *   @brief   Moves the formation along a parabola.
+ *   @details Each column is lifted onto the curve at the x it will have
+ *            once the formation has moved, so the rows bend around it.
+ *   @return  void
+ */
+void SpaceInvaders::quadraticAlienMovement(float dt)
 {
-  auto dt_sec = game_time.delta.count() / 1000.0;
+  formation.velocity = Velocity{ alien_x_velocity, 0 };
+  formation.transform.y = 0;
+  formation.followPath(quadratic_path, alien_x_velocity * dt);
+}
 
-  for (int i = 0; i < alien_count; i++)
-  {
-    aliens[i].setVelocity(Vector2{ alien_x_velocity, alien_y_velocity });
+/**
+ *   @brief   Moves the formation along a sine wave.
+ *   @details The whole formation rises and falls with the wave traced
+ *            by its left edge, read from the sampled path.
+ *   @return  void
+ */
+void SpaceInvaders::sineAlienMovement(float dt)
+{
+  formation.velocity = Velocity{ alien_x_velocity, 0 };
+  formation.transform.y +=
+    sine_path(formation.transform.x + alien_x_velocity * dt) * dt;
+  formation.flatten();
+}
 
-    aliens[i].spriteComponent()->getSprite()->xPos(
-      aliens[i].spriteComponent()->getSprite()->xPos() +
-      aliens[i].getVelocity().x * dt_sec);
+/**
+ *   @brief   Moves the invading formation.
+ *   @details The formation bounces off the screen edges using the
+ *            bounds of its live aliens, so it still reaches the edge as
+ *            outer columns are destroyed. Only the formation moves,
+ *            the aliens follow it through their slots.
+ *   @return  void
+ */
+void SpaceInvaders::alienMovement(float dt)
+{
+  if (formation.live() == 0)
+  {
+    return;
+  }
 
-    aliens[i].spriteComponent()->getSprite()->yPos(
-      aliens[i].spriteComponent()->getSprite()->yPos() +
-      aliens[i].getVelocity().y * dt_sec);
+  const Box bounds = formation.bounds();
+  if (bounds.x <= 0 ||
+      bounds.x + bounds.width >= static_cast<float>(game_width))
+  {
+    alien_x_velocity *= -1;
+    alien_y_pos += formation.slotHeight();
+  }
 
-    alien_y_velocity = alien_y_velocity + 4.9 * dt_sec;
+  // a wave may set its own movement over the one picked on the menu
+  const int movement =
+    scenario.movement >= 0 ? scenario.movement : menu_option;
+  if (movement == 0)
+  {
+    linearAlienMovement(dt);
   }
+  else if (movement == 1)
+  {
+    gravitationalAlienMovement(dt);
+  }
+  else if (movement == 2)
+  {
+    quadraticAlienMovement(dt);
+  }
+  else if (movement == 3)
+  {
+    sineAlienMovement(dt);
+  }
+
+  formation.move(dt);
 }
 
-void SpaceInvaders::quadraticAlienMovement(const ASGE::GameTime& game_time)
+/**
+ *   @brief   Moves a pool of shots
+ *   @details The live shots are advanced in chunks, then those that
+ *            left the screen are released in one pass.
+ *   @return  void
+ */
+void SpaceInvaders::moveShots(ProjectilePool& shots, float dt)
 {
-  auto dt_sec = game_time.delta.count() / 1000.0;
+  shots.storePositions();
 
-  // y = 0.001 * pow(x - 640.0, 2.0)
+  auto advance = [&shots, dt](size_t begin, size_t end) {
+    shots.advance(dt, begin, end);
+  };
+  jobs.parallelFor(shots.live().size(), SYSTEM_GRAIN, advance);
 
-  // SUPER HAPPY FUN TIME CODE
-  /*
-  for (int i = 0; i < alien_count; i++) {
-      aliens[i].setVelocity(Vector2{alien_x_velocity, alien_x_velocity});
+  shots.cull(Box{ 0,
+                  0,
+                  static_cast<float>(game_width),
+                  static_cast<float>(game_height) });
+}
 
-      aliens[i].spriteComponent()->getSprite()->xPos(
-              aliens[i].spriteComponent()->getSprite()->xPos() +
-  aliens[i].getVelocity().x * dt_sec);
+/**
+ *   @brief   Rebuilds the collision grid
+ *   @details Every live barrier and the defender are inserted so
+ *            that lasers and aliens only narrow phase test the
+ *            obstacles that share a cell with them. The bounds of all
+ *            the obstacles are kept so aliens nowhere near them can
+ *            skip their query entirely. Aliens themselves are packed
+ *            and swept by the overlap kernel instead. Barriers are
+ *            hashed by their index, and only their bounds are hashed:
+ *            what is left of them is tested a row at a time.
+ *   @return  void
+ */
+void SpaceInvaders::buildBroadPhase()
+{
+  defender_box = colliderBox(registry, defender.entity());
+  obstacle_bounds = defender_box;
 
-      aliens[i].spriteComponent()->getSprite()->yPos(aliens[i].spriteComponent()->getSprite()->yPos()
-  + (0.0001 * pow((aliens[i].spriteComponent()->getSprite()->xPos() -
-  640.0), 2.0)) * dt_sec);
-  }
-   */
+  broad_phase.clear();
+  broad_phase.insert(SpatialHash::id(DEFENDER_LAYER, 0), defender_box);
 
-  for (int i = 0; i < alien_count; i++)
+  for (std::uint32_t i = 0; i < barriers.size(); i++)
   {
-    aliens[i].setVelocity(Vector2{ alien_x_velocity, 0 });
-
-    aliens[i].spriteComponent()->getSprite()->xPos(
-      aliens[i].spriteComponent()->getSprite()->xPos() +
-      aliens[i].getVelocity().x * dt_sec);
-
-    if (i < 10)
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(
-        (-0.0002 *
-         pow(aliens[i].spriteComponent()->getSprite()->xPos() - 640.0, 2.0)) +
-        200);
-    }
-    else if (i >= 10 && i < 20)
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(
-        (-0.0002 *
-         pow(aliens[i].spriteComponent()->getSprite()->xPos() - 640.0, 2.0)) +
-        220);
-    }
-    else if (i >= 20 && i < 30)
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(
-        (-0.0002 *
-         pow(aliens[i].spriteComponent()->getSprite()->xPos() - 640.0, 2.0)) +
-        240);
-    }
-    else if (i >= 30 && i < 40)
+    if (!barriers.destroyed(i))
     {
-      aliens[i].spriteComponent()->getSprite()->yPos(
-        (-0.0002 *
-         pow(aliens[i].spriteComponent()->getSprite()->xPos() - 640.0, 2.0)) +
-        260);
+      const Box barrier = barriers.box(i);
+      broad_phase.insert(SpatialHash::id(BARRIER_LAYER, i), barrier);
+      obstacle_bounds = merge(obstacle_bounds, barrier);
     }
-    else
-    {
-      aliens[i].spriteComponent()->getSprite()->yPos(
-        (-0.0002 *
-         pow(aliens[i].spriteComponent()->getSprite()->xPos() - 640.0, 2.0)) +
-        280);
-    }
-
-    // ASGE::DebugPrinter{} << aliens[i].spriteComponent()->getSprite()->yPos()
-    // << std::endl;
+  }
+}
 
-    /*if (aliens[4].spriteComponent()->getSprite()->xPos() <= 460)
+/**
+ *   @brief   Resolves lasers hitting aliens and barriers
+ *   @details A laser is spent on the first thing it hits. Aliens are
+ *            worth 10 points, barriers lose the piece that was hit.
+ *            Each laser sweeps the packed alien arrays with the batched
+ *            overlap kernel, 64 aliens at a time.
+ *   @return  void
+ */
+void SpaceInvaders::laserCollisions()
+{
+  const auto& live = player_shots.live();
+  for (size_t i = live.size(); i > 0; --i)
+  {
+    const std::uint32_t shot = live[i - 1];
+    const Box laser = player_shots.box(shot);
+    if (laserHitsAlien(laser) || laserHitsBarrier(laser, false))
     {
-        aliens[i].spriteComponent()->getSprite()->yPos(aliens[i].spriteComponent()->getSprite()->yPos()
-    + ( 0.001 * pow(aliens->spriteComponent()->getSprite()->xPos() -
-    460.0, 2.0)) * dt_sec);
+      player_shots.release(shot);
     }
-    else
-    {
-        aliens[i].spriteComponent()->getSprite()->yPos(aliens[i].spriteComponent()->getSprite()->yPos()
-    - ( 0.001 * pow(aliens->spriteComponent()->getSprite()->xPos() -
-    460.0, 2.0)) * dt_sec);
-    }*/
   }
 }
 
-void SpaceInvaders::sineAlienMovement(const ASGE::GameTime& game_time)
+/**
+ *   @brief   Resolves alien lasers hitting barriers and the defender
+ *   @details Alien lasers are spent on the first barrier they hit. One
+ *            reaching the defender loses the game, unless the scenario
+ *            is endless.
+ *   @return  void
+ */
+void SpaceInvaders::alienShotCollisions()
 {
-  auto dt_sec = game_time.delta.count() / 1000.0;
-
-  for (int i = 0; i < alien_count; i++)
+  const auto& live = alien_shots.live();
+  for (size_t i = live.size(); i > 0; --i)
   {
-    aliens[i].setVelocity(Vector2{ alien_x_velocity, 0 });
-
-    aliens[i].spriteComponent()->getSprite()->xPos(
-      aliens[i].spriteComponent()->getSprite()->xPos() +
-      aliens[i].getVelocity().x * dt_sec);
-
-    aliens[i].spriteComponent()->getSprite()->yPos(
-      aliens[i].spriteComponent()->getSprite()->yPos() +
-      (50 * sin(0.01 * aliens->spriteComponent()->getSprite()->xPos())) *
-        dt_sec);
+    const std::uint32_t shot = live[i - 1];
+    const Box laser = alien_shots.box(shot);
+    if (overlaps(laser, defender_box) && !scenario.endless)
+    {
+      in_game = false;
+      lose = true;
+    }
 
-    // SUPER HAPPY FUN TIME CODE v2
-    /*
-    aliens[i].spriteComponent()->getSprite()->yPos(
-      aliens[i].spriteComponent()->getSprite()->yPos() +
-      (50 * sin(0.01 * aliens[i].spriteComponent()->getSprite()->xPos())) *
-        dt_sec);
-        */
+    if (laserHitsBarrier(laser, true))
+    {
+      alien_shots.release(shot);
+    }
   }
 }
 
-void SpaceInvaders::alienMovement(const ASGE::GameTime& game_time)
+/**
+ *   @brief   Finds the first live barrier hit by a laser
+ *   @details The laser blasts a crater where it first meets a live
+ *            cell. A laser passing through a gap in a barrier carries on.
+ *   @return  True if the laser hit a barrier.
+ */
+bool SpaceInvaders::laserHitsBarrier(const Box& laser, bool downwards)
 {
-  if (aliens[0].spriteComponent()->getSprite()->xPos() <= 0 ||
-      aliens[9].spriteComponent()->getSprite()->xPos() +
-          aliens[9].spriteComponent()->getSprite()->width() >=
-        game_width)
+  if (!overlaps(laser, obstacle_bounds))
   {
-    alien_x_velocity *= -1;
-    alien_y_pos += aliens->spriteComponent()->getSprite()->height();
+    return false;
   }
 
-  if (menu_option == 0)
-  {
-    linearAlienMovement(game_time);
-  }
-  else if (menu_option == 1)
+  broad_phase.query(laser, candidates);
+  for (auto candidate : candidates)
   {
-    gravitationalAlienMovement(game_time);
+    if (SpatialHash::layerOf(candidate) == BARRIER_LAYER &&
+        barriers.shoot(SpatialHash::indexOf(candidate), laser, downwards))
+    {
+      ++static_version;
+      return true;
+    }
   }
-  else if (menu_option == 2)
+
+  return false;
+}
+
+/**
+ *   @brief   Fires a volley of alien lasers on the alien fire interval
+ *   @details Each alien is picked by a fixed seed generator, so replays
+ *            see the same shots. Its state is kept alongside it, for
+ *            snapshots to save. The pick is out of the whole formation,
+ *            so picks past the aliens still alive skip their shot and
+ *            the fire thins out as the formation does. A full pool
+ *            ends the volley.
+ *   @return  void
+ */
+void SpaceInvaders::alienFire()
+{
+  if (timestep.tick() % scenario.fire_interval != 0)
   {
-    quadraticAlienMovement(game_time);
+    return;
   }
-  else if (menu_option == 3)
+
+  for (size_t shot = 0; shot < scenario.volley; ++shot)
   {
-    sineAlienMovement(game_time);
+    alien_fire_state = static_cast<std::uint32_t>(alien_fire_rng());
+    const size_t pick = alien_fire_state % scenario.aliens;
+    if (pick >= registry.slots.size())
+    {
+      continue;
+    }
+
+    const FormationSlot& slot = registry.slots.data()[pick];
+    const Box alien = formation.slotBox(slot.column, slot.row);
+    if (alien_shots.acquire(alien.x + alien.width / 2 -
+                              alien_shots.width() / 2,
+                            alien.y + alien.height,
+                            0,
+                            ALIEN_SHOT_SPEED) < 0)
+    {
+      return;
+    }
   }
 }
 
-bool SpaceInvaders::isOverlapping(ASGE::Sprite* sprite1, ASGE::Sprite* sprite2)
+/**
+ *   @brief   Fires a laser from the top of the defender
+ *   @details A full pool simply holds fire until a shot expires.
+ *   @return  True if a laser was fired.
+ */
+bool SpaceInvaders::defenderFire()
 {
-  if ((sprite2->xPos() <= sprite1->xPos() + sprite1->width()) &&
-      (sprite2->xPos() + sprite2->width() >= sprite1->xPos()) &&
+  const Box muzzle = colliderBox(registry, defender.entity());
+  return player_shots.acquire(muzzle.x + muzzle.width / 2 -
+                                player_shots.width() / 2,
+                              muzzle.y - player_shots.height(),
+                              0,
+                              PLAYER_SHOT_SPEED) >= 0;
+}
 
-      (sprite2->yPos() <= sprite1->yPos() + sprite1->height()) &&
-      (sprite2->yPos() + sprite2->height() >= sprite1->yPos()))
+/**
+ *   @brief   Finds the first live alien hit by a laser
+ *   @details The alien is damaged, and the score awarded if that
+ *            kills it.
+ *   @return  True if the laser hit an alien.
+ */
+bool SpaceInvaders::laserHitsAlien(const Box& laser)
+{
+  for (size_t first = 0; first < packed_aliens.size(); first += OVERLAP_BATCH)
   {
-    return true;
+    const size_t count = std::min(OVERLAP_BATCH, packed_aliens.size() - first);
+    auto hits = overlapMask(laser,
+                            packed_aliens.x.data() + first,
+                            packed_aliens.y.data() + first,
+                            packed_aliens.width.data() + first,
+                            packed_aliens.height.data() + first,
+                            count);
+
+    while (hits)
+    {
+      const size_t index = first + lowestBit(hits);
+      if (packed_aliens.alive[index])
+      {
+        const Entity alien = packed_aliens.entity[index];
+        const FormationSlot slot = registry.slots.get(alien);
+        if (applyDamage(registry, alien, 1))
+        {
+          formation.kill(slot.column, slot.row);
+          kills.push_back(alien);
+          packed_aliens.alive[index] = 0;
+          aliens_left--;
+          score += 10;
+        }
+        return true;
+      }
+      hits &= hits - 1;
+    }
   }
+
+  return false;
 }
 
 /**
- *   @brief   Updates the scene
- *   @details Prepares the renderer subsystem before drawing the
- *            current frame. Once the current frame is has finished
- *            the buffers are swapped accordingly and the image shown.
+ *   @brief   Resolves aliens reaching the barriers and the defender
+ *   @details Aliens crush the cells of any barrier under them. The game
+ *            is lost when a live alien touches the defender or reaches
+ *            its row, unless the scenario is endless.
+ *            Chunks of aliens query the grid in parallel, each noting
+ *            what it found, and the findings are then applied in chunk
+ *            order so the outcome does not depend on the thread count.
  *   @return  void
  */
-void SpaceInvaders::update(const ASGE::GameTime& game_time)
+void SpaceInvaders::alienCollisions()
 {
-  auto dt_sec = game_time.delta.count() / 1000.0;
-  // make sure you use delta time in any movement calculations!
-
-  if (in_game)
-  {
-    defender.spriteComponent()->getSprite()->xPos(
-      defender.spriteComponent()->getSprite()->xPos() +
-      (defender.getVelocity().x * dt_sec));
-
-    alienMovement(game_time);
-
-    for (int i = 0; i < laser_count; i++)
+  auto detect = [this](size_t begin, size_t end) {
+    const size_t chunk = begin / SYSTEM_GRAIN;
+    auto& found = chunk_candidates[chunk];
+    auto& crushed = chunk_crushed[chunk];
+    crushed.clear();
+    chunk_landed[chunk] = 0;
+
+    for (size_t i = begin; i < end; i++)
     {
-      if (lasers[i].visibility)
+      if (!packed_aliens.alive[i])
       {
-        lasers[i].spriteComponent()->getSprite()->yPos(
-          lasers[i].spriteComponent()->getSprite()->yPos() +
-          lasers[i].getVelocity().y * dt_sec);
+        continue;
       }
-      if (lasers[i].spriteComponent()->getSprite()->yPos() +
-            lasers[i].spriteComponent()->getSprite()->height() <=
-          0)
+
+      const Box alien = packed_aliens.box(i);
+      if (alien.y + alien.height >= defender_box.y)
       {
-        lasers[i].visibility = false;
+        chunk_landed[chunk] = 1;
       }
-    }
 
-    for (int i = 0; i < alien_count; i++)
-    {
-      for (int j = 0; j < laser_count; j++)
+      if (!overlaps(alien, obstacle_bounds))
       {
-        if (isOverlapping(lasers[j].spriteComponent()->getSprite(),
-                          aliens[i].spriteComponent()->getSprite()) &&
-            aliens[i].visibility && lasers[j].visibility)
-        {
-          // ASGE::DebugPrinter{} << "HIT" << std::endl;
-          lasers[j].visibility = false;
-          aliens[i].visibility = false;
-          aliens_left--;
-          // ASGE::DebugPrinter{} << "aliens left: " << aliens_left <<
-          // std::endl;
-          score += 10;
-        }
+        continue;
       }
 
-      for (int i = 0; i < alien_count; i++)
+      broad_phase.query(alien, found);
+
+      for (auto candidate : found)
       {
-        if (aliens[i].spriteComponent()->getSprite()->yPos() +
-              aliens[i].spriteComponent()->getSprite()->height() >=
-            defender.spriteComponent()->getSprite()->yPos())
+        const auto obstacle = SpatialHash::indexOf(candidate);
+        const auto layer = SpatialHash::layerOf(candidate);
+
+        if (layer == BARRIER_LAYER && overlaps(alien, barriers.box(obstacle)))
+        {
+          crushed.emplace_back(obstacle, alien);
+        }
+        else if (layer == DEFENDER_LAYER && overlaps(alien, defender_box))
         {
-          in_game = false;
-          lose = true;
+          chunk_landed[chunk] = 1;
         }
       }
+    }
+  };
+
+  jobs.parallelFor(packed_aliens.size(), SYSTEM_GRAIN, detect);
+
+  for (size_t chunk = 0; chunk * SYSTEM_GRAIN < packed_aliens.size(); ++chunk)
+  {
+    if (chunk_landed[chunk] && !scenario.endless)
+    {
+      in_game = false;
+      lose = true;
+    }
 
-      if (aliens_left == 0)
+    for (const auto& crush : chunk_crushed[chunk])
+    {
+      if (barriers.crush(crush.first, crush.second))
       {
-        in_game = false;
-        win = true;
+        ++static_version;
       }
     }
   }
 }
 
 /**
- *   @brief   Renders the scene
- *   @details Renders all the game objects to the current frame.
- *            Once the current frame is has finished the buffers are
- *            swapped accordingly and the image shown.
+ *   @brief   Updates the scene
+ *   @details Streams in assets, which must be uploaded on this thread,
+ *            as must any level being built or a quick save restored,
+ *            then sets the frame simulating as a job so that it runs
+ *            while render draws the frame before it.
  *   @return  void
  */
-
-/*void renderMenuScreen(const ASGE::GameTime&)
+void SpaceInvaders::update(const ASGE::GameTime& game_time)
 {
+  ScopedZone zone("update");
 
-}
-void renderGameScreen(const ASGE::GameTime&)
-{
+  // the earliest the game runs after the last frame's swap
+  frame_start = Profiler::now();
+  if (latency.enabled())
+  {
+    latency.presented();
+  }
 
-}
-void renderPauseScreen(const ASGE::GameTime&)
-{
+  if (!assets_ready)
+  {
+    streamAssets(UPLOADS_PER_FRAME);
+  }
 
-}*/
+  frame_seconds = game_time.delta.count() / 1000.0;
 
-void SpaceInvaders::render(const ASGE::GameTime&)
-{
-  renderer->setFont(0);
+  if (restart_level || next_wave)
+  {
+    // a restart goes back to the first wave, clearing one the next
+    wave = restart_level ? 0 : wave + 1;
+    score = restart_level ? 0 : score;
+    restart_level = false;
+    next_wave = false;
+    if (!initLevel())
+    {
+      signalExit();
+    }
+  }
 
-  /*renderMenuScreen();
-  renderGameScreen();
-  renderPauseScreen();*/
+  if (restore_requested)
+  {
+    restore_requested = false;
+    if (!restoreState(quick_save))
+    {
+      ASGE::DebugPrinter{} << "quick save could not be restored" << std::endl;
+    }
+  }
 
-  if (in_menu)
+  simulation = jobs.create(&SpaceInvaders::simulateJob, this, 0, 1);
+  if (simulation == nullptr)
   {
-    renderer->renderText("MENU", game_width / 2, 40, 1.0, ASGE::COLOURS::WHITE);
+    simulate();
+    return;
+  }
 
-    renderer->renderText(menu_option == 0 ? ">STRAIGHT LINE" : "STRAIGHT LINE",
-                         (game_width / 2.0f),
-                         (game_height * 0.5f),
-                         1.0,
-                         ASGE::COLOURS::WHITE);
+  jobs.submit(simulation);
+}
 
-    renderer->renderText(menu_option == 1 ? ">GRAVITY CURVE" : "GRAVITY CURVE",
-                         (game_width / 2.0f),
-                         (game_height * 0.6f),
-                         1.0,
-                         ASGE::COLOURS::WHITE);
+void SpaceInvaders::simulateJob(void* context, size_t /*begin*/, size_t /*end*/)
+{
+  static_cast<SpaceInvaders*>(context)->simulate();
+}
 
-    renderer->renderText(menu_option == 2 ? ">QUADRATIC CURVE"
-                                          : "QUADRATIC CURVE",
-                         (game_width / 2.0f),
-                         (game_height * 0.7f),
-                         1.0,
-                         ASGE::COLOURS::WHITE);
+/**
+ *   @brief   Simulates a frame
+ *   @details The frame time is banked and the game simulated in fixed
+ *            ticks, so the same inputs always produce the same game
+ *            regardless of the frame rate. Queued input events are
+ *            applied before each tick, so they always land on a tick
+ *            boundary. Whatever the ticks leave on screen is then
+ *            published for render.
+ *   @return  void
+ */
+void SpaceInvaders::simulate()
+{
+  ScopedZone zone("simulate");
 
-    renderer->renderText(menu_option == 3 ? ">SINE CURVE" : "SINE CURVE",
-                         (game_width / 2.0f),
-                         (game_height * 0.8f),
-                         1.0,
-                         ASGE::COLOURS::WHITE);
+  drainInputs();
+  if (replaying_inputs)
+  {
+    playInputs();
   }
 
   if (in_game)
   {
-    // renderer->renderText("IN GAME", game_width / 2, game_height / 2, 1.0,
-    // ASGE::COLOURS::WHITE);
-
-    renderer->renderSprite(*defender.spriteComponent()->getSprite());
-
-    for (int i = 0; i < alien_count; i++)
+#ifdef HEADLESS
+    // headless frames are not paced by a display, so each is one tick
+    unsigned int ticks = 1;
+#else
+    unsigned int ticks = timestep.advance(frame_seconds);
+#endif
+
+    for (; ticks > 0 && in_game; --ticks)
     {
-      if (aliens[i].visibility)
+      tick(timestep.step());
+
+      drainInputs();
+      if (replaying_inputs)
       {
-        renderer->renderSprite(*aliens[i].spriteComponent()->getSprite());
+        playInputs();
       }
     }
+  }
+
+  writeFrame();
+}
+
+/**
+ *   @brief   Simulates a single tick
+ *   @details Runs the tick's systems. Positions from the last tick are
+ *            kept before anything moves, for render to interpolate
+ *            from. When keeping a history, the tick's end state is
+ *            snapshotted into it.
+ *   @return  void
+ */
+void SpaceInvaders::tick(float dt)
+{
+  systems.run(dt, registry.size() >= PARALLEL_SYSTEM_ENTITIES);
+
+  if (aliens_left == 0 && wave + 1 < waves.size())
+  {
+    next_wave = true;
+  }
+  else if (aliens_left == 0)
+  {
+    in_game = false;
+    win = true;
+  }
+
+  timestep.endTick();
+
+  if (keeping_history)
+  {
+    saveState(tick_snapshot);
+    state_history.push(tick_snapshot);
+  }
+}
+
+/**
+ *   @brief   Publishes the frame
+ *   @details Copies everything shown this frame into the next frame
+ *            packet, with positions interpolated between the last two
+ *            ticks, then hands it over to render. The barriers and the
+ *            earth make up the static layer, which is only copied into
+ *            a packet that holds an older version of it.
+ *   @return  void
+ */
+void SpaceInvaders::writeFrame()
+{
+  FramePacket& packet = frames.write();
+  packet.clear();
+  packet.frame = ++frames_written;
 
-    for (int i = 0; i < laser_count; i++)
+  if (latency.enabled())
+  {
+    latency.write(timestep.tick(), packet);
+  }
+
+  // showing or hiding a layer changes it as much as a barrier breaking
+  const int state = (in_game ? 1 : 0) | (lose ? 2 : 0);
+  if (state != static_state)
+  {
+    static_state = state;
+    ++static_version;
+  }
+
+  if (packet.static_version != static_version)
+  {
+    packet.clearStatic(static_version);
+    if (in_game)
     {
-      if (lasers[i].visibility)
-      {
-        renderer->renderSprite(*lasers[i].spriteComponent()->getSprite());
-      }
+      writeStaticSprites(registry, packet);
+      barriers.writeStaticSprites(BARRIER_SPRITE, ENTITY_Z, packet);
     }
 
-    for (int i = 0; i < barrier_count; i++)
+    if (lose)
     {
-      renderer->renderSprite(*barriers[i].spriteComponent()->getSprite());
+      const ASGE::Sprite* earth_sprite =
+        registry.sprites.get(earth)->getSprite();
+      packet.addStaticSprite(
+        EARTH_SPRITE, earth_sprite->xPos(), earth_sprite->yPos(), BACKDROP_Z);
     }
+  }
+
+  const auto width = static_cast<float>(game_width);
+  const auto height = static_cast<float>(game_height);
+
+  if (in_menu)
+  {
+    packet.addText("MENU", width / 2, 40);
+    packet.addText("STRAIGHT LINE", width / 2, height * 0.5F);
+    packet.addText("GRAVITY CURVE", width / 2, height * 0.6F);
+    packet.addText("QUADRATIC CURVE", width / 2, height * 0.7F);
+    packet.addText("SINE CURVE", width / 2, height * 0.8F);
+
+    // the marker is its own line, so the options themselves never change
+    packet.addText(">",
+                   width / 2 - MENU_MARKER_INDENT,
+                   height * (0.5F + 0.1F * static_cast<float>(menu_option)));
+  }
 
-    renderer->renderText("SCORE: " + std::to_string(score),
-                         game_width - 110,
-                         game_height - 6,
-                         1.0,
-                         ASGE::COLOURS::WHITE);
+  if (in_game)
+  {
+    const float alpha = timestep.alpha();
+    writeSprites(registry, alpha, packet);
+    writeFormation(registry, formation, alpha, packet);
+    player_shots.writeSprites(alpha, LASER_SPRITE, SHOT_Z, packet);
+    alien_shots.writeSprites(alpha, ALIEN_LASER_SPRITE, SHOT_Z, packet);
+
+    char score_text[TextDraw::LENGTH];
+    std::snprintf(score_text, sizeof(score_text), "SCORE: %d", score);
+    packet.addText(score_text, width - 110, height - 6);
   }
 
   if (in_pause)
   {
-    renderer->renderText(
-      "PAUSED", game_width / 2, game_height / 2, 1.0, ASGE::COLOURS::WHITE);
+    packet.addText("PAUSED", width / 2, height / 2);
   }
 
   if (win)
   {
-    renderer->renderText(
-      "WIN", game_width / 2, game_height / 2, 1.0, ASGE::COLOURS::WHITE);
+    packet.addText("WIN", width / 2, height / 2);
   }
+
   if (lose)
   {
-    renderer->renderText("GAME OVER",
-                         (game_width / 2.0) - 30.0,
-                         earth.spriteComponent()->getSprite()->yPos() - 20.0,
-                         1.0,
-                         ASGE::COLOURS::WHITE);
+    const ASGE::Sprite* earth_sprite = registry.sprites.get(earth)->getSprite();
+    packet.addText("GAME OVER", width / 2 - 30, earth_sprite->yPos() - 20);
+  }
+
+  frames.publish();
+}
+
+/**
+ *   @brief   Joins the frame's simulation
+ *   @details Input is polled once render returns, so the simulation must
+ *            be finished by then for the key handler to change the game.
+ *            The jobs the frame used are recycled for the next.
+ *   @return  void
+ */
+void SpaceInvaders::awaitSimulation()
+{
+  ScopedZone zone("awaitSimulation");
+
+  if (simulation != nullptr)
+  {
+    jobs.wait(simulation);
+    simulation = nullptr;
+  }
+
+  jobs.reset();
+}
+
+/**
+ *   @brief   Renders the scene
+ *   @details Draws the latest frame the simulation has published, which
+ *            until this frame's simulation finishes is the one before.
+ *            Once the current frame is has finished the buffers are
+ *            swapped accordingly and the image shown.
+ *   @return  void
+ */
+void SpaceInvaders::render(const ASGE::GameTime&)
+{
+  ScopedZone zone("render");
+
+  const FramePacket& packet = frames.read();
+  if (!first_frame_rendered && packet.frame != 0)
+  {
+    first_frame_rendered = true;
+    ASGE::DebugPrinter{} << "first frame after "
+                         << std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - launch_time)
+                              .count()
+                         << "ms" << std::endl;
+  }
+
+  renderer->setFont(0);
+
+  {
+    ScopedZone batch("renderSprite frame");
+    frame_renderer.render(renderer.get(), packet);
+  }
+
+  if (latency.enabled())
+  {
+    latency.rendered(packet);
+  }
+
+  if (show_profiler)
+  {
+    renderProfiler();
+  }
+
+  awaitSimulation();
+}
 
-    renderer->renderSprite(*earth.spriteComponent()->getSprite());
+/**
+ *   @brief   Draws the profiler overlay
+ *   @details Lists every zone that completed in the last second, with
+ *            how often it ran and its mean and worst duration.
+ *   @return  void
+ */
+void SpaceInvaders::renderProfiler()
+{
+  const std::int64_t one_second = 1000000000;
+  Profiler::getInstance().summarise(Profiler::now() - one_second, zone_stats);
+
+  int line_y = 20;
+  renderer->renderText("ZONE                    CALLS   MEAN MS    MAX MS",
+                       10,
+                       line_y,
+                       0.5F,
+                       ASGE::COLOURS::WHITE);
+
+  for (const auto& zone : zone_stats)
+  {
+    char line[96];
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-22.22s %6u %9.3f %9.3f",
+                  zone.name,
+                  zone.calls,
+                  zone.total_ms / zone.calls,
+                  zone.max_ms);
+
+    line_y += 14;
+    renderer->renderText(line, 10, line_y, 0.5F, ASGE::COLOURS::WHITE);
   }
+
+  char batches[32];
+  std::snprintf(
+    batches, sizeof(batches), "SPRITE BATCHES %zu", frame_renderer.batches());
+  renderer->renderText(batches, 10, line_y + 14, 0.5F, ASGE::COLOURS::WHITE);
 }
@@ -1,62 +1,280 @@
 #pragma once
 #include "Utility/Vector2.h"
-#include <Engine/OGLGame.h>
 #include <string>
 
+#include "ECS/Registry.h"
+#include "ECS/SystemSchedule.h"
+#include "ECS/Systems.h"
+#include "GameObjects/Barriers.h"
 #include "GameObjects/GameObject.h"
+#include "GameObjects/ProjectilePool.h"
+#include "Input/InputQueue.h"
+#include "Jobs/JobSystem.h"
+#include "Levels/Scenario.h"
+#include "Levels/WaveCache.h"
+#include "Memory/Arena.h"
+#include "Movement/Formation.h"
+#include "Movement/Trajectory.h"
+#include "Physics/OverlapKernel.h"
+#include "Physics/SpatialHash.h"
+#include "Profiler/LatencyTracer.h"
+#include "Profiler/Profiler.h"
+#include "Rendering/FramePacket.h"
+#include "Rendering/FrameRenderer.h"
+#include "Rendering/TripleBuffer.h"
+#include "Replay/InputRecording.h"
+#include "Replay/StateHistory.h"
+#include "Resources/AssetLoader.h"
+#include "Utility/FixedTimestep.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifdef HEADLESS
+#  include "Headless/HeadlessGame.h"
+using GameBase = HeadlessGame;
+#else
+#  include <Engine/OGLGame.h>
+using GameBase = ASGE::OGLGame;
+#endif
 
 /**
  *  An OpenGL Game based on ASGE.
+ *  When built with HEADLESS defined the game runs against a null
+ *  renderer instead, without a window or GL context.
  */
-class SpaceInvaders : public ASGE::OGLGame
+class SpaceInvaders : public GameBase
 {
  public:
   SpaceInvaders();
   ~SpaceInvaders() final;
   bool init() override;
 
+  /**
+   *  Sets what every level is made of, in place of the waves in the
+   *  data folder. Call before init. The alien count, aliens per row and
+   *  fire interval are raised to at least one.
+   *  @param [in] level The scenario to play
+   */
+  void setScenario(const Scenario& level);
+
+  /**
+   *  Records every key event the game sees from now on.
+   *  @see saveRecording
+   */
+  void recordInputs();
+
+  /**
+   *  Writes the recorded key events, along with the number of ticks
+   *  simulated, so the session can be replayed.
+   *  @param [in] file_name The file to write
+   *  @return true if the file was written
+   */
+  bool saveRecording(const std::string& file_name);
+
+  /**
+   *  Plays back a recorded session in place of live input. The game
+   *  exits once it has simulated the ticks the session ran for.
+   *  @param [in] file_name The recording to replay
+   *  @return true if the recording was loaded
+   */
+  bool replayInputs(const std::string& file_name);
+
+  /**
+   *  The number of ticks the replayed session ran for.
+   *  @return the recorded session length, in ticks
+   */
+  unsigned long long replayLength() const noexcept;
+
+  unsigned long long ticksRun() const noexcept;
+
+  /**
+   *  Follows every input that moves the defender or fires to the screen.
+   *  @param [in] expected_inputs Inputs to reserve room for up front
+   */
+  void traceLatency(size_t expected_inputs);
+
+  /**
+   *  Writes the input latencies traced so far.
+   *  @param [in] out Where the report is written
+   */
+  void reportLatency(std::ostream& out) const;
+
+  /**
+   *  Saves the whole simulation, everything a tick reads, to a flat
+   *  buffer. Call between ticks.
+   *  @param [out] snapshot The saved state, replaced
+   */
+  void saveState(std::vector<std::uint8_t>& snapshot) const;
+
+  /**
+   *  Puts the simulation back as it was when a snapshot was saved. The
+   *  level is rebuilt, so call from the thread that owns the renderer
+   *  while the simulation is not running. A snapshot from another
+   *  build or with other shot pools is rejected without touching the
+   *  game; one that fails part way through leaves a fresh build of the
+   *  wave that was being played, with the score kept.
+   *  @param [in] snapshot A snapshot saved by this build of the game
+   *  @return true if the snapshot was restored
+   */
+  bool restoreState(const std::vector<std::uint8_t>& snapshot);
+
+  /**
+   *  Builds the current wave again from scratch, as a restart does.
+   *  Call from the thread that owns the renderer while the simulation
+   *  is not running.
+   *  @return true if every game object was created
+   */
+  bool rebuildLevel();
+
+  /** The arena the level's components are created in. */
+  const Arena& levelArena() const noexcept;
+
+  /**
+   *  Snapshots the simulation after every tick from now on.
+   *  @param [in] expected_ticks Ticks to reserve room for up front
+   */
+  void keepHistory(size_t expected_ticks);
+  const StateHistory& history() const noexcept;
+
  private:
   void keyHandler(ASGE::SharedEventData data);
   void clickHandler(ASGE::SharedEventData data);
   void setupResolution();
+  void streamAssets(size_t budget);
+  bool initLevel();
+  void initSystems();
 
-  bool isOverlapping(ASGE::Sprite*, ASGE::Sprite*);
+  void moveShots(ProjectilePool& shots, float dt);
+  void buildBroadPhase();
+  void laserCollisions();
+  bool laserHitsAlien(const Box& laser);
+  bool laserHitsBarrier(const Box& laser, bool downwards);
+  void alienShotCollisions();
+  void alienFire();
+  bool defenderFire();
+  void alienCollisions();
 
   void update(const ASGE::GameTime&) override;
+  static void simulateJob(void* context, size_t begin, size_t end);
+  void simulate();
+  void tick(float dt);
+  void playInputs();
+  void drainInputs();
+  bool applyInput(const ASGE::KeyEvent& key);
+  void writeFrame();
+  void awaitSimulation();
   void render(const ASGE::GameTime&) override;
+  void renderProfiler();
 
-  /*void renderMenuScreen(const ASGE::GameTime&);
-  void renderGameScreen(const ASGE::GameTime&);
-  void renderPauseScreen(const ASGE::GameTime&);*/
+  FixedTimestep timestep;
+  double frame_seconds = 0;
 
-  int alien_count = 50;
-  int aliens_left = alien_count;
-  int laser_count = 5;
-  int barrier_count = 36;
+  // the simulation publishes each frame for render to draw
+  JobSystem::Job* simulation = nullptr;
+  TripleBuffer<FramePacket> frames;
+  unsigned long long frames_written = 0;
+  FrameRenderer frame_renderer;
 
-  int current_shot_index = 0;
+  // bumped whenever what the static layer shows changes
+  unsigned long long static_version = 1;
+  int static_state = 0;
+
+  std::atomic<bool> show_profiler{ false };
+  std::vector<ZoneStats> zone_stats;
+
+  InputRecording recording;
+  bool recording_inputs = false;
+  InputRecording replay;
+  bool replaying_inputs = false;
+  InputQueue input_queue;
+  LatencyTracer latency;
+  std::int64_t frame_start = 0;
+  ASGE::KeyEvent input_event; /**< The input being applied. */
+  bool restart_level = false;
+
+  std::vector<std::uint8_t> quick_save;
+  bool restore_requested = false;
+  StateHistory state_history;
+  bool keeping_history = false;
+  std::vector<std::uint8_t> tick_snapshot;
+
+  AssetLoader assets;
+  bool assets_ready = false;
+  bool start_on_load = false;
+
+  std::chrono::steady_clock::time_point launch_time;
+  bool first_frame_rendered = false;
+
+  Scenario scenario;
+  bool scenario_set = false;
+  WaveCache waves;
+  size_t wave = 0;
+  bool next_wave = false;
+  int aliens_left = static_cast<int>(scenario.aliens);
+
+  Arena level_arena;
+  Registry registry{ level_arena };
+
+  enum TickAccess : std::uint32_t
+  {
+    PLAYER_SHOT_ACCESS = FIRST_GAME_ACCESS,
+    ALIEN_SHOT_ACCESS = FIRST_GAME_ACCESS << 1U,
+    GAME_STATE_ACCESS = FIRST_GAME_ACCESS << 2U
+  };
+
+  JobSystem jobs;
+  SystemSchedule systems{ jobs };
 
   bool initDefender();
   GameObject defender;
   bool initAliens();
-  GameObject aliens[50];
-  bool initLasers();
-  GameObject lasers[5];
+  Formation formation;
+  bool initShots();
+  ProjectilePool player_shots;
+  ProjectilePool alien_shots;
+  std::minstd_rand alien_fire_rng;
+  std::uint32_t alien_fire_state = std::minstd_rand::default_seed;
+  std::vector<Entity> kills; /**< Aliens killed this level, in order. */
   bool initBarriers();
-  GameObject barriers[36];
+  Barriers barriers;
   bool initEarth();
-  GameObject earth;
+  Entity earth = NULL_ENTITY;
+
+  enum CollisionLayer : std::uint32_t
+  {
+    BARRIER_LAYER,
+    DEFENDER_LAYER,
+    ALIEN_LAYER
+  };
 
-  void linearAlienMovement(const ASGE::GameTime& game_time);
-  void gravitationalAlienMovement(const ASGE::GameTime& game_time);
-  void quadraticAlienMovement(const ASGE::GameTime& game_time);
-  void sineAlienMovement(const ASGE::GameTime& game_time);
+  SpatialHash broad_phase;
+  PackedColliders packed_aliens;
 
-  void alienMovement(const ASGE::GameTime& game_time);
-  const float GRAVITY = 9.8;
-  float alien_x_velocity = 200;
+  // results of each chunk of aliens, combined once every chunk is done
+  std::vector<std::vector<std::uint32_t>> chunk_candidates;
+  std::vector<std::vector<std::pair<std::uint32_t, Box>>> chunk_crushed;
+  std::vector<std::uint8_t> chunk_landed;
+  std::vector<std::uint32_t> candidates;
+  Box defender_box;
+  Box obstacle_bounds;
+
+  void linearAlienMovement(float dt);
+  void gravitationalAlienMovement(float dt);
+  void quadraticAlienMovement(float dt);
+  void sineAlienMovement(float dt);
+
+  void alienMovement(float dt);
+  float alien_x_velocity = 0;
   float alien_y_velocity = 0;
-  float alien_y_pos = 20;
+  float alien_y_pos = 0;
+
+  PolynomialTrajectory quadratic_path;
+  TableTrajectory sine_path;
 
   int key_callback_id = -1;   /**< Key Input Callback ID. */
   int mouse_callback_id = -1; /**< Mouse Input Callback ID. */
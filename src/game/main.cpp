@@ -1,10 +1,181 @@
 #include "game.h"
-int main()
+
+#ifdef HEADLESS
+#  include <Engine/Keys.h>
+#  include <cstdlib>
+#  include <cstring>
+#  include <iostream>
+#  include <string>
+#  include <vector>
+
+namespace
 {
+  constexpr size_t LATENCY_INPUTS = 4096;
+}
+
+/**
+ *  Usage: SpaceInvadersHeadless [frames] [movement mode 0-3]
+ *                               [--record file] [--replay file]
+ *                               [--trace file] [--latency]
+ *  Selects the movement mode from the menu, starts the game and
+ *  simulates the requested number of frames as fast as possible.
+ *  A replay supplies its own input instead and runs until the
+ *  session it recorded ends, unless a frame count is given. A trace
+ *  holds the profiler zones of the last few thousand frames, and
+ *  latency reports how long inputs took to reach the screen.
+ */
+int main(int argc, char* argv[])
+{
+  std::vector<const char*> args;
+  const char* record_file = nullptr;
+  const char* replay_file = nullptr;
+  const char* trace_file = nullptr;
+  bool latency = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+    {
+      record_file = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+    {
+      replay_file = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+    {
+      trace_file = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--latency") == 0)
+    {
+      latency = true;
+    }
+    else
+    {
+      args.push_back(argv[i]);
+    }
+  }
+
+  unsigned long long frames = !args.empty()
+                                ? std::strtoull(args[0], nullptr, 10)
+                                : (replay_file != nullptr ? 0 : 10000);
+  int mode = args.size() > 1 ? std::atoi(args[1]) : 0;
+
+  SpaceInvaders asge_game;
+  if (!asge_game.init())
+  {
+    return 1;
+  }
+
+  if (record_file != nullptr)
+  {
+    asge_game.recordInputs();
+  }
+
+  if (replay_file != nullptr)
+  {
+    if (!asge_game.replayInputs(replay_file))
+    {
+      std::cerr << "could not load " << replay_file << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    for (int i = 0; i < mode; ++i)
+    {
+      asge_game.sendKey(ASGE::KEYS::KEY_DOWN, ASGE::KEYS::KEY_RELEASED);
+    }
+    asge_game.sendKey(ASGE::KEYS::KEY_ENTER, ASGE::KEYS::KEY_PRESSED);
+  }
+
+  if (latency)
+  {
+    asge_game.traceLatency(LATENCY_INPUTS);
+  }
+
+  asge_game.frameLimit(frames);
+  asge_game.run();
+
+  if (record_file != nullptr && !asge_game.saveRecording(record_file))
+  {
+    std::cerr << "could not write " << record_file << std::endl;
+    return 1;
+  }
+
+  if (trace_file != nullptr &&
+      !Profiler::getInstance().exportTrace(trace_file))
+  {
+    std::cerr << "could not write " << trace_file << std::endl;
+    return 1;
+  }
+
+  auto frames_run = asge_game.framesRun();
+  std::cout << frames_run << " frames, " << asge_game.ticksRun()
+            << " ticks in " << asge_game.secondsRun() << "s ("
+            << static_cast<double>(frames_run) / asge_game.secondsRun()
+            << " fps)" << std::endl;
+
+  if (latency)
+  {
+    asge_game.reportLatency(std::cout);
+  }
+  return 0;
+}
+#else
+#  include <cstring>
+#  include <iostream>
+
+namespace
+{
+  constexpr size_t LATENCY_INPUTS = 4096;
+}
+
+/**
+ *  Usage: SpaceInvaders [--record file] [--latency]
+ *  Recording saves the session's key presses for headless replay.
+ *  Latency reports how long inputs took to reach the screen on exit.
+ */
+int main(int argc, char* argv[])
+{
+  const char* record_file = nullptr;
+  bool latency = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+    {
+      record_file = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--latency") == 0)
+    {
+      latency = true;
+    }
+  }
+
   SpaceInvaders asge_game;
   if (asge_game.init())
   {
+    if (record_file != nullptr)
+    {
+      asge_game.recordInputs();
+    }
+
+    if (latency)
+    {
+      asge_game.traceLatency(LATENCY_INPUTS);
+    }
+
     asge_game.run();
+
+    if (record_file != nullptr)
+    {
+      asge_game.saveRecording(record_file);
+    }
+
+    if (latency)
+    {
+      asge_game.reportLatency(std::cout);
+    }
   }
   return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Packs every PNG under an image folder into one or more texture atlases.
+
+Writes atlas pages as RGBA PNGs next to a JSON manifest that maps each
+image, by the path the game loads it from, to its page and sub-rect:
+
+    pack_atlas.py <image dir> <virtual prefix> <output dir> [first...]
+
+e.g. pack_atlas.py data/images /data/images build/bin/data/atlas \
+         /data/images/defender.png
+
+Images listed after the output dir are packed before anything else, so
+the ones drawn every frame share the first page. Pages are referenced
+in the manifest as /data/<output dir name>/atlasN.png.
+
+Only the Python standard library is used so the build has no extra
+dependencies. Supports 8 bit RGB and RGBA, non-interlaced PNGs, which
+covers everything the game ships.
+"""
+import json
+import os
+import struct
+import sys
+import zlib
+
+PAGE_SIZE = 2048
+PADDING = 2
+SIGNATURE = b"\x89PNG\r\n\x1a\n"
+
+
+def read_png(path):
+    with open(path, "rb") as png:
+        data = png.read()
+    if data[:8] != SIGNATURE:
+        raise ValueError(path + " is not a PNG")
+
+    offset, idat = 8, []
+    while offset < len(data):
+        length, kind = struct.unpack(">I4s", data[offset:offset + 8])
+        body = data[offset + 8:offset + 8 + length]
+        if kind == b"IHDR":
+            width, height, depth, colour, _, _, interlace = \
+                struct.unpack(">IIBBBBB", body)
+        elif kind == b"IDAT":
+            idat.append(body)
+        elif kind == b"IEND":
+            break
+        offset += 12 + length
+
+    if depth != 8 or colour not in (2, 6) or interlace:
+        raise ValueError(path + " is not an 8 bit RGB(A) PNG")
+
+    channels = 4 if colour == 6 else 3
+    stride = width * channels
+    raw = zlib.decompress(b"".join(idat))
+    pixels = bytearray(height * width * 4)
+    previous = bytearray(stride)
+
+    for row in range(height):
+        start = row * (stride + 1)
+        kind = raw[start]
+        line = bytearray(raw[start + 1:start + 1 + stride])
+        unfilter(kind, line, previous, channels)
+
+        if channels == 4:
+            pixels[row * width * 4:(row + 1) * width * 4] = line
+        else:
+            target = row * width * 4
+            for x in range(width):
+                pixels[target + x * 4:target + x * 4 + 3] = \
+                    line[x * 3:x * 3 + 3]
+                pixels[target + x * 4 + 3] = 255
+        previous = line
+
+    return width, height, pixels
+
+
+def unfilter(kind, line, previous, bpp):
+    if kind == 0:
+        return
+    if kind == 1:
+        for i in range(bpp, len(line)):
+            line[i] = (line[i] + line[i - bpp]) & 0xFF
+    elif kind == 2:
+        for i in range(len(line)):
+            line[i] = (line[i] + previous[i]) & 0xFF
+    elif kind == 3:
+        for i in range(len(line)):
+            left = line[i - bpp] if i >= bpp else 0
+            line[i] = (line[i] + ((left + previous[i]) >> 1)) & 0xFF
+    elif kind == 4:
+        for i in range(len(line)):
+            a = line[i - bpp] if i >= bpp else 0
+            b = previous[i]
+            c = previous[i - bpp] if i >= bpp else 0
+            p = a + b - c
+            pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+            if pa <= pb and pa <= pc:
+                predictor = a
+            elif pb <= pc:
+                predictor = b
+            else:
+                predictor = c
+            line[i] = (line[i] + predictor) & 0xFF
+    else:
+        raise ValueError("unknown PNG filter %d" % kind)
+
+
+def write_png(path, width, height, pixels):
+    def chunk(kind, body):
+        return (struct.pack(">I", len(body)) + kind + body +
+                struct.pack(">I", zlib.crc32(kind + body) & 0xFFFFFFFF))
+
+    stride = width * 4
+    raw = b"".join(b"\x00" + bytes(pixels[row * stride:(row + 1) * stride])
+                   for row in range(height))
+    header = struct.pack(">IIBBBBB", width, height, 8, 6, 0, 0, 0)
+
+    with open(path, "wb") as png:
+        png.write(SIGNATURE)
+        png.write(chunk(b"IHDR", header))
+        png.write(chunk(b"IDAT", zlib.compress(raw, 6)))
+        png.write(chunk(b"IEND", b""))
+
+
+def pack(images, first):
+    """Shelf packs the images, tallest first, opening pages as needed."""
+    pages, placements = [], {}
+    rest = sorted((name for name in images if name not in first),
+                  key=lambda name: (-images[name][1], name))
+    order = [name for name in first if name in images] + rest
+
+    for name in order:
+        width, height, _ = images[name]
+        if width + PADDING > PAGE_SIZE or height + PADDING > PAGE_SIZE:
+            raise ValueError(name + " does not fit on an atlas page")
+
+        for index, page in enumerate(pages):
+            if page["x"] + width + PADDING > PAGE_SIZE:
+                page["x"], page["y"] = 0, page["y"] + page["shelf"]
+                page["shelf"] = 0
+            if page["y"] + height + PADDING <= PAGE_SIZE:
+                break
+        else:
+            pages.append({"x": 0, "y": 0, "shelf": 0, "height": 0})
+            index, page = len(pages) - 1, pages[-1]
+
+        placements[name] = (index, page["x"], page["y"])
+        page["x"] += width + PADDING
+        page["shelf"] = max(page["shelf"], height + PADDING)
+        page["height"] = max(page["height"], page["y"] + height)
+
+    return pages, placements
+
+
+def main(image_dir, prefix, output_dir, *first):
+    images = {}
+    for root, _, files in os.walk(image_dir):
+        for file in files:
+            if file.lower().endswith(".png"):
+                path = os.path.join(root, file)
+                name = prefix + "/" + os.path.relpath(path, image_dir)
+                images[name.replace(os.sep, "/")] = read_png(path)
+
+    missing = [name for name in first if name not in images]
+    if missing:
+        raise ValueError("not found: " + ", ".join(missing))
+
+    pages, placements = pack(images, first)
+    os.makedirs(output_dir, exist_ok=True)
+    virtual_dir = "/data/" + os.path.basename(os.path.normpath(output_dir))
+
+    manifest = {"pages": [], "sprites": {}}
+    for index, page in enumerate(pages):
+        pixels = bytearray(PAGE_SIZE * page["height"] * 4)
+        for name, (page_index, x, y) in placements.items():
+            if page_index != index:
+                continue
+            width, height, source = images[name]
+            for row in range(height):
+                target = ((y + row) * PAGE_SIZE + x) * 4
+                pixels[target:target + width * 4] = \
+                    source[row * width * 4:(row + 1) * width * 4]
+
+        file = "atlas%d.png" % index
+        write_png(os.path.join(output_dir, file), PAGE_SIZE, page["height"],
+                  pixels)
+        manifest["pages"].append(virtual_dir + "/" + file)
+
+    for name, (page, x, y) in sorted(placements.items()):
+        width, height, _ = images[name]
+        manifest["sprites"][name] = {
+            "page": page, "x": x, "y": y, "w": width, "h": height}
+
+    with open(os.path.join(output_dir, "atlas.json"), "w") as out:
+        json.dump(manifest, out, indent=1, sort_keys=True)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 4:
+        sys.exit(__doc__)
+    main(*sys.argv[1:])